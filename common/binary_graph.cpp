@@ -0,0 +1,192 @@
+#include "binary_graph.h"
+#include "mapped_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+constexpr uint64_t SECTION_ALIGNMENT = 64;
+
+uint64_t alignUp(uint64_t value) {
+  return (value + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+inline uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * @brief Position-dependent hash of a byte array, read as 64-bit words
+ *
+ * Every word is mixed with its index and the results are summed, so the
+ * words can be hashed in any order by any number of threads. A partial last
+ * word is zero extended.
+ */
+uint64_t hashBytes(const void *data, uint64_t bytes, uint64_t seed) {
+  const unsigned char *base = static_cast<const unsigned char *>(data);
+  const int64_t full_words = static_cast<int64_t>(bytes / 8);
+
+  uint64_t sum = 0;
+  #pragma omp parallel for schedule(static) reduction(+ : sum)
+  for (int64_t i = 0; i < full_words; i++) {
+    uint64_t word;
+    memcpy(&word, base + i * 8, 8);
+    sum += mix64(word + seed + static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL);
+  }
+
+  if (bytes % 8 != 0) {
+    uint64_t word = 0;
+    memcpy(&word, base + full_words * 8, bytes % 8);
+    sum += mix64(word + seed + static_cast<uint64_t>(full_words) * 0x9e3779b97f4a7c15ULL);
+  }
+  return mix64(sum ^ bytes);
+}
+
+uint64_t graphChecksum(uint64_t vertices, const CSRGraph::edgeIndex *offsets,
+                       uint64_t adjacencies, const graphNode *adjacency) {
+  uint64_t offset_hash = hashBytes(offsets, (vertices + 1) * sizeof(CSRGraph::edgeIndex), 1);
+  uint64_t adjacency_hash = hashBytes(adjacency, adjacencies * sizeof(graphNode), 2);
+  return mix64(offset_hash + 3 * adjacency_hash);
+}
+
+/**
+ * @brief True if row starts never decrease and every neighbor id is in [0, vertices)
+ *
+ * Engines index by both without bounds checks, so a truncated or edited file
+ * that slipped past the header checks would otherwise read out of bounds.
+ */
+bool hasValidStructure(uint64_t vertices, const CSRGraph::edgeIndex *offsets,
+                       uint64_t adjacencies, const graphNode *adjacency) {
+  const int64_t rows = static_cast<int64_t>(vertices);
+  bool valid = true;
+  #pragma omp parallel for schedule(static) reduction(&& : valid)
+  for (int64_t v = 0; v < rows; v++) {
+    valid = valid && offsets[v] <= offsets[v + 1];
+  }
+  if (!valid) return false;
+
+  const int64_t entries = static_cast<int64_t>(adjacencies);
+  const graphNode bound = static_cast<graphNode>(vertices);
+  #pragma omp parallel for schedule(static) reduction(&& : valid)
+  for (int64_t i = 0; i < entries; i++) {
+    valid = valid && adjacency[i] >= 0 && adjacency[i] < bound;
+  }
+  return valid;
+}
+
+bool writePadding(std::ofstream &out, uint64_t position, uint64_t target) {
+  static const char zeros[SECTION_ALIGNMENT] = {};
+  if (target > position) {
+    out.write(zeros, static_cast<std::streamsize>(target - position));
+  }
+  return static_cast<bool>(out);
+}
+
+bool reject(const std::string &fileName, const char *reason) {
+  std::cerr << "Error: " << fileName << ": " << reason << std::endl;
+  return false;
+}
+
+} // namespace
+
+bool isBinaryGraphFile(const std::string &fileName) {
+  std::ifstream in(fileName, std::ios::binary);
+  char magic[sizeof(BINARY_GRAPH_MAGIC)];
+  return in.read(magic, sizeof(magic)) &&
+         memcmp(magic, BINARY_GRAPH_MAGIC, sizeof(BINARY_GRAPH_MAGIC)) == 0;
+}
+
+bool writeBinaryGraph(const std::string &fileName, const CSRGraph &graph) {
+  const uint64_t vertices = static_cast<uint64_t>(graph.numVertices());
+  const uint64_t adjacencies = graph.numAdjacencies();
+
+  BinaryGraphHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+  header.version = BINARY_GRAPH_VERSION;
+  header.header_size = sizeof(BinaryGraphHeader);
+  header.num_vertices = vertices;
+  header.num_adjacencies = adjacencies;
+  header.offsets_start = alignUp(sizeof(BinaryGraphHeader));
+  header.adjacency_start =
+      alignUp(header.offsets_start + (vertices + 1) * sizeof(CSRGraph::edgeIndex));
+  header.checksum =
+      graphChecksum(vertices, graph.offsetData(), adjacencies, graph.adjacencyData());
+
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writePadding(out, sizeof(header), header.offsets_start);
+  out.write(reinterpret_cast<const char *>(graph.offsetData()),
+            static_cast<std::streamsize>((vertices + 1) * sizeof(CSRGraph::edgeIndex)));
+  writePadding(out, header.offsets_start + (vertices + 1) * sizeof(CSRGraph::edgeIndex),
+               header.adjacency_start);
+  out.write(reinterpret_cast<const char *>(graph.adjacencyData()),
+            static_cast<std::streamsize>(adjacencies * sizeof(graphNode)));
+  out.flush();
+  return static_cast<bool>(out);
+}
+
+bool loadBinaryGraph(const std::string &fileName, CSRGraph &graph, bool verify_checksum) {
+  auto file = std::make_shared<MappedFile>(fileName);
+  if (!file->isOpen()) {
+    return false;
+  }
+  if (file->size() < sizeof(BinaryGraphHeader)) {
+    return reject(fileName, "truncated binary graph header");
+  }
+
+  BinaryGraphHeader header;
+  memcpy(&header, file->data(), sizeof(header));
+  if (memcmp(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic)) != 0) {
+    return reject(fileName, "not a binary graph file");
+  }
+  if (header.version != BINARY_GRAPH_VERSION || header.header_size != sizeof(BinaryGraphHeader)) {
+    return reject(fileName, "unsupported binary graph version");
+  }
+  if (header.num_vertices > static_cast<uint64_t>(INT32_MAX)) {
+    return reject(fileName, "vertex count exceeds 32-bit ids");
+  }
+
+  const uint64_t offset_bytes = (header.num_vertices + 1) * sizeof(CSRGraph::edgeIndex);
+  const uint64_t adjacency_bytes = header.num_adjacencies * sizeof(graphNode);
+  if (header.offsets_start > file->size() || header.adjacency_start > file->size() ||
+      header.offsets_start % SECTION_ALIGNMENT != 0 ||
+      header.adjacency_start % SECTION_ALIGNMENT != 0 ||
+      header.offsets_start < sizeof(BinaryGraphHeader) ||
+      header.adjacency_start < header.offsets_start + offset_bytes ||
+      header.num_adjacencies > file->size() / sizeof(graphNode) ||
+      header.adjacency_start + adjacency_bytes > file->size()) {
+    return reject(fileName, "section bounds do not match the file size");
+  }
+
+  const auto *offsets =
+      reinterpret_cast<const CSRGraph::edgeIndex *>(file->data() + header.offsets_start);
+  const auto *adjacency = reinterpret_cast<const graphNode *>(file->data() + header.adjacency_start);
+  if (offsets[0] != 0 || offsets[header.num_vertices] != header.num_adjacencies) {
+    return reject(fileName, "offsets do not match the adjacency count");
+  }
+
+  if (verify_checksum && graphChecksum(header.num_vertices, offsets, header.num_adjacencies,
+                                       adjacency) != header.checksum) {
+    return reject(fileName, "checksum mismatch");
+  }
+  if (!hasValidStructure(header.num_vertices, offsets, header.num_adjacencies, adjacency)) {
+    return reject(fileName, "offsets out of order or neighbor ids out of range");
+  }
+
+  graph = CSRGraph(static_cast<int>(header.num_vertices), offsets, adjacency,
+                   std::shared_ptr<const void>(file));
+  return true;
+}
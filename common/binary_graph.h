@@ -0,0 +1,68 @@
+/**
+ * @file binary_graph.h
+ * @brief Compact on-disk CSR format that loads with a single mmap
+ *
+ * Layout, all integers little-endian:
+ *   [0, 64)            BinaryGraphHeader
+ *   offsets_start      (num_vertices + 1) uint64 row starts
+ *   adjacency_start    num_adjacencies int32 neighbor ids
+ * Both arrays start on a 64-byte boundary; the gaps are zero padding. The
+ * checksum is taken over the two arrays, not the padding.
+ *
+ * Loading maps the file and hands the arrays to CSRGraph as they are, so a
+ * graph that takes minutes to parse as text is ready in milliseconds. Row
+ * clean-up (CSRBuildOptions) is applied once when the file is written.
+ */
+
+#ifndef BINARY_GRAPH_H
+#define BINARY_GRAPH_H
+
+#include <cstdint>
+#include <string>
+
+#include "csr_graph.h"
+
+constexpr char BINARY_GRAPH_MAGIC[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+constexpr uint32_t BINARY_GRAPH_VERSION = 1;
+
+struct BinaryGraphHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint64_t num_vertices;
+  uint64_t num_adjacencies;
+  uint64_t offsets_start;
+  uint64_t adjacency_start;
+  uint64_t checksum;
+  uint64_t reserved;
+};
+
+static_assert(sizeof(BinaryGraphHeader) == 64, "binary graph header must stay 64 bytes");
+
+/**
+ * @brief True if fileName starts with the binary graph magic
+ */
+bool isBinaryGraphFile(const std::string &fileName);
+
+/**
+ * @brief Writes graph in the binary format
+ *
+ * @return False if the file cannot be written
+ */
+bool writeBinaryGraph(const std::string &fileName, const CSRGraph &graph);
+
+/**
+ * @brief Maps a binary graph file and views it without copying
+ *
+ * The header, array bounds and CSR structure (row starts in order, neighbor
+ * ids in range) are always validated, in one parallel pass over the arrays.
+ * The checksum additionally catches edits that keep the structure valid.
+ *
+ * @param fileName Path of the binary graph
+ * @param graph Output graph, keeps the mapping alive
+ * @param verify_checksum Recompute and compare the payload checksum
+ * @return False if the file cannot be mapped or fails validation
+ */
+bool loadBinaryGraph(const std::string &fileName, CSRGraph &graph, bool verify_checksum = false);
+
+#endif // BINARY_GRAPH_H
@@ -0,0 +1,103 @@
+/**
+ * @file bucket_queue.h
+ * @brief Vertex priority queue for integer keys that move by one at a time
+ *
+ * Every key has a bucket holding a doubly linked list of its vertices, so
+ * increment, decrement and remove are O(1) and the extreme buckets are found
+ * by moving a cursor. Over an ordering that changes keys once per incident
+ * edge, the cursors move O(V + E) steps in total, which is what makes
+ * smallest-last, incidence-degree and Gorder linear-time.
+ */
+
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "csr_graph.h"
+
+class BucketQueue {
+public:
+  /**
+   * @brief Queues vertices [0, keys.size()) with the given non-negative keys
+   *
+   * Within a bucket, vertices come out in id order until keys change.
+   */
+  explicit BucketQueue(const std::vector<int> &keys)
+      : key(keys), prev(keys.size()), next(keys.size()), removed(keys.size(), 0) {
+    int max_key = 0;
+    for (int k : key) max_key = std::max(max_key, k);
+    head.assign(max_key + 1, -1);
+    for (int v = static_cast<int>(key.size()) - 1; v >= 0; v--) link(v);
+    bottom = 0;
+    top = max_key;
+  }
+
+  bool contains(graphNode v) const { return !removed[v]; }
+  int keyOf(graphNode v) const { return key[v]; }
+
+  void increment(graphNode v) {
+    unlink(v);
+    key[v]++;
+    if (key[v] >= static_cast<int>(head.size())) head.push_back(-1);
+    link(v);
+    top = std::max(top, key[v]);
+  }
+
+  void decrement(graphNode v) {
+    unlink(v);
+    key[v]--;
+    link(v);
+    bottom = std::min(bottom, key[v]);
+  }
+
+  void remove(graphNode v) {
+    unlink(v);
+    removed[v] = 1;
+  }
+
+  // Vertex with the lowest key, or -1 once every vertex is removed
+  graphNode popMin() {
+    while (bottom < static_cast<int>(head.size()) && head[bottom] < 0) bottom++;
+    if (bottom == static_cast<int>(head.size())) return -1;
+    graphNode v = head[bottom];
+    remove(v);
+    return v;
+  }
+
+  // Vertex with the highest key, or -1 once every vertex is removed
+  graphNode popMax() {
+    while (top > 0 && head[top] < 0) top--;
+    graphNode v = head[top];
+    if (v >= 0) remove(v);
+    return v;
+  }
+
+private:
+  void link(graphNode v) {
+    prev[v] = -1;
+    next[v] = head[key[v]];
+    if (next[v] >= 0) prev[next[v]] = v;
+    head[key[v]] = v;
+  }
+
+  void unlink(graphNode v) {
+    if (prev[v] >= 0) {
+      next[prev[v]] = next[v];
+    } else {
+      head[key[v]] = next[v];
+    }
+    if (next[v] >= 0) prev[next[v]] = prev[v];
+  }
+
+  std::vector<int> key;
+  std::vector<graphNode> prev;
+  std::vector<graphNode> next;
+  std::vector<char> removed;
+  std::vector<graphNode> head;  // First vertex of every key's bucket
+  int bottom;                   // No non-empty bucket below
+  int top;                      // No non-empty bucket above
+};
+
+#endif // BUCKET_QUEUE_H
@@ -0,0 +1,147 @@
+#include "color_balancing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include "forbidden_colors.h"
+#include "phase_timer.h"
+
+namespace {
+
+// Largest class over smallest; infinite when a class is empty
+double sizeRatio(const std::vector<std::atomic<int>> &sizes) {
+  int largest = 0;
+  int smallest = std::numeric_limits<int>::max();
+  for (const auto &size : sizes) {
+    largest = std::max(largest, size.load(std::memory_order_relaxed));
+    smallest = std::min(smallest, size.load(std::memory_order_relaxed));
+  }
+  if (sizes.empty()) return 1;
+  return smallest > 0 ? static_cast<double>(largest) / smallest
+                      : std::numeric_limits<double>::infinity();
+}
+
+// Self-loops count, as in the validator: no coloring can satisfy them
+bool hasConflicts(const CSRGraph &graph, const std::vector<color> &colors) {
+  bool conflict = false;
+  #pragma omp parallel for schedule(dynamic, 256) reduction(|| : conflict)
+  for (int v = 0; v < graph.numVertices(); v++) {
+    for (graphNode u : graph.neighbors(v)) {
+      if (colors[u] == colors[v]) conflict = true;
+    }
+  }
+  return conflict;
+}
+
+} // namespace
+
+BalanceStats balanceColorClasses(const CSRGraph &graph, std::vector<color> &colors,
+                                 const BalanceOptions &options) {
+  PhaseTimer::Scope phase(Phase::Recolor);
+  const auto start = std::chrono::steady_clock::now();
+
+  BalanceStats stats;
+  const int n = graph.numVertices();
+  if (static_cast<int>(colors.size()) != n) return stats;
+  int num_colors = 0;
+  for (int v = 0; v < n; v++) {
+    if (colors[v] < 0) return stats;
+    num_colors = std::max(num_colors, colors[v] + 1);
+  }
+  // Moving a vertex next to a conflict could race with the conflicting neighbor's move
+  if (hasConflicts(graph, colors)) return stats;
+
+  stats.applied = true;
+  stats.colors = num_colors;
+  if (num_colors == 0) return stats;
+  const int target = (n + num_colors - 1) / num_colors;
+  stats.target_size = target;
+
+  std::vector<std::atomic<int>> sizes(num_colors);
+  std::vector<int> class_start(num_colors + 1);
+  std::vector<graphNode> members(n);
+  std::vector<int> targets;
+
+  for (int round = 0; round < options.max_rounds; round++) {
+    // Group the vertices by class and take fresh sizes
+    std::fill(class_start.begin(), class_start.end(), 0);
+    for (int v = 0; v < n; v++) class_start[colors[v] + 1]++;
+    for (int c = 0; c < num_colors; c++) class_start[c + 1] += class_start[c];
+    std::vector<int> cursor(class_start.begin(), class_start.end() - 1);
+    for (int v = 0; v < n; v++) members[cursor[colors[v]]++] = v;
+    for (int c = 0; c < num_colors; c++) {
+      sizes[c].store(class_start[c + 1] - class_start[c], std::memory_order_relaxed);
+    }
+    if (round == 0) stats.initial_ratio = sizeRatio(sizes);
+
+    long long round_moved = 0;
+    for (int source = 0; source < num_colors; source++) {
+      if (sizes[source].load(std::memory_order_relaxed) <= target) continue;
+
+      // Undersized classes, smallest first, as of the start of this source
+      targets.clear();
+      for (int c = 0; c < num_colors; c++) {
+        if (sizes[c].load(std::memory_order_relaxed) < target) targets.push_back(c);
+      }
+      if (targets.empty()) break;
+      std::sort(targets.begin(), targets.end(), [&sizes](int a, int b) {
+        return sizes[a].load(std::memory_order_relaxed) < sizes[b].load(std::memory_order_relaxed);
+      });
+
+      #pragma omp parallel for schedule(dynamic, 256) reduction(+ : round_moved)
+      for (int i = class_start[source]; i < class_start[source + 1]; i++) {
+        if (sizes[source].load(std::memory_order_relaxed) <= target) continue;
+        const graphNode v = members[i];
+        ForbiddenColors &forbidden = ForbiddenColors::local();
+        forbidden.clear();
+        for (graphNode u : graph.neighbors(v)) {
+          forbidden.forbid(colors[u]);
+        }
+
+        for (int c : targets) {
+          if (forbidden.isForbidden(c)) continue;
+          // Reserve a slot in the target, then release one in the source
+          if (sizes[c].fetch_add(1, std::memory_order_relaxed) >= target) {
+            sizes[c].fetch_sub(1, std::memory_order_relaxed);
+            continue;
+          }
+          if (sizes[source].fetch_sub(1, std::memory_order_relaxed) <= target) {
+            sizes[source].fetch_add(1, std::memory_order_relaxed);
+            sizes[c].fetch_sub(1, std::memory_order_relaxed);
+            break;
+          }
+          colors[v] = c;
+          round_moved++;
+          break;
+        }
+      }
+    }
+
+    stats.rounds++;
+    stats.moved += round_moved;
+    if (round_moved == 0) break;
+  }
+
+  stats.final_ratio = sizeRatio(sizes);
+  stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+void printBalanceStats(std::ostream &out, const BalanceStats &stats) {
+  if (!stats.applied) {
+    out << "Balancing skipped: the engine's coloring is incomplete or has conflicts" << std::endl;
+    return;
+  }
+  out << "Balanced " << stats.colors << " classes toward " << stats.target_size
+      << " vertices: max/min ratio " << stats.initial_ratio << " -> " << stats.final_ratio << ", "
+      << stats.moved << " vertices moved in " << stats.rounds << " rounds (" << stats.seconds
+      << " s)" << std::endl;
+}
+
+void BalancedColorGraph::colorGraph(const CSRGraph &graph, std::vector<color> &colors) {
+  engine->colorGraph(graph, colors);
+  printBalanceStats(std::cout, balanceColorClasses(graph, colors, options));
+}
@@ -0,0 +1,73 @@
+/**
+ * @file color_balancing.h
+ * @brief Evens out color class sizes after any engine, for equitable colorings
+ *
+ * Consumers that run each color class as one parallel batch wait on the
+ * largest class, so a proper coloring with a skewed histogram wastes their
+ * threads. The balancing pass moves vertices out of classes above the
+ * target size ceil(V / colors) into classes below it whenever no neighbor
+ * already has the target color. The color count never changes.
+ *
+ * Source classes are drained one at a time, with their vertices spread over
+ * the threads: a class is an independent set, so none of the vertices being
+ * moved is a neighbor of another, and every move stays proper. Class sizes
+ * are atomic counters, so concurrent moves into one target stop at the
+ * target size. Rounds repeat, from fresh class sizes, while vertices move.
+ */
+
+#ifndef COLOR_BALANCING_H
+#define COLOR_BALANCING_H
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "color_graph.h"
+#include "csr_graph.h"
+
+struct BalanceOptions {
+  int max_rounds = 8;
+};
+
+struct BalanceStats {
+  int colors = 0;
+  int target_size = 0;  // ceil(V / colors)
+  double initial_ratio = 0;  // Largest over smallest class; infinite with an empty class
+  double final_ratio = 0;
+  long long moved = 0;  // Vertices that changed class
+  int rounds = 0;
+  double seconds = 0;
+  bool applied = false;  // False if the input was not a complete proper coloring
+};
+
+/**
+ * @brief Moves vertices from oversized to undersized classes, in place
+ *
+ * Colorings with uncolored vertices, conflicting edges or self-loops are
+ * left unchanged, with applied false.
+ */
+BalanceStats balanceColorClasses(const CSRGraph &graph, std::vector<color> &colors,
+                                 const BalanceOptions &options = BalanceOptions());
+
+/**
+ * @brief One line: max/min class ratio before and after, vertices moved and time
+ */
+void printBalanceStats(std::ostream &out, const BalanceStats &stats);
+
+/**
+ * @brief Runs an engine, then balances its color classes
+ */
+class BalancedColorGraph : public ColorGraph {
+public:
+  BalancedColorGraph(std::unique_ptr<ColorGraph> engine, const BalanceOptions &options)
+      : engine(std::move(engine)), options(options) {}
+
+  void colorGraph(const CSRGraph &graph, std::vector<color> &colors) override;
+  using ColorGraph::colorGraph;
+
+private:
+  std::unique_ptr<ColorGraph> engine;
+  BalanceOptions options;
+};
+
+#endif // COLOR_BALANCING_H
@@ -0,0 +1,56 @@
+/**
+ * @file color_graph.h
+ * @brief Interface implemented by every coloring engine
+ *
+ * Shared by the traditional and transactional builds and by the unified
+ * driver, which links engines from both trees into one binary.
+ */
+
+#ifndef COLOR_GRAPH_H
+#define COLOR_GRAPH_H
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "csr_graph.h"
+
+/**
+ * @brief Copies a dense coloring into a map keyed by vertex id
+ */
+inline void exportColorMap(const std::vector<color> &colors,
+                           std::unordered_map<graphNode, color> &colorMap) {
+  colorMap.clear();
+  colorMap.reserve(colors.size());
+  for (size_t v = 0; v < colors.size(); v++) {
+    colorMap[static_cast<graphNode>(v)] = colors[v];
+  }
+}
+
+class ColorGraph {
+public:
+  // colors is resized to numVertices() and indexed by vertex id; -1 means uncolored
+  virtual void colorGraph(const CSRGraph &graph, std::vector<color> &colors) = 0;
+  virtual ~ColorGraph() = default;
+
+  // Optional export for callers that want the coloring as a map
+  void colorGraph(const CSRGraph &graph, std::unordered_map<graphNode, color> &colors) {
+    std::vector<color> dense;
+    colorGraph(graph, dense);
+    exportColorMap(dense, colors);
+  }
+
+  // Compatibility adapters for callers still using the map-of-vectors adjacency
+  void buildGraph(std::vector<graphNode> &nodes,
+                  std::vector<std::pair<graphNode, graphNode>> &pairs,
+                  std::unordered_map<graphNode, std::vector<graphNode>> &graph) {
+    CSRGraph::fromEdges(static_cast<int>(nodes.size()), pairs).toAdjacencyMap(graph);
+  }
+  void colorGraph(std::unordered_map<graphNode, std::vector<graphNode>> &graph,
+                  std::unordered_map<graphNode, color> &colors) {
+    colorGraph(CSRGraph::fromAdjacencyMap(graph), colors);
+  }
+};
+
+#endif // COLOR_GRAPH_H
@@ -0,0 +1,171 @@
+#include "coloring_order.h"
+
+#include <algorithm>
+
+#include "bucket_queue.h"
+
+std::atomic<bool> PresetColoringOrder::active_flag{false};
+
+namespace {
+
+std::vector<int> degrees(const CSRGraph &graph) {
+  std::vector<int> result(graph.numVertices());
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v < graph.numVertices(); v++) {
+    result[v] = graph.degree(v);
+  }
+  return result;
+}
+
+// Descending degree, ties in id order
+std::vector<graphNode> largestFirst(const CSRGraph &graph) {
+  const int n = graph.numVertices();
+  int max_degree = 0;
+  for (int v = 0; v < n; v++) max_degree = std::max(max_degree, graph.degree(v));
+
+  std::vector<int> starts(max_degree + 2, 0);
+  for (int v = 0; v < n; v++) starts[max_degree - graph.degree(v) + 1]++;
+  for (int d = 0; d <= max_degree; d++) starts[d + 1] += starts[d];
+
+  std::vector<graphNode> order(n);
+  for (int v = 0; v < n; v++) order[starts[max_degree - graph.degree(v)]++] = v;
+  return order;
+}
+
+std::vector<graphNode> smallestLast(const CSRGraph &graph) {
+  const int n = graph.numVertices();
+  BucketQueue queue(degrees(graph));
+  std::vector<graphNode> order(n);
+
+  // Removal fills the order from the back
+  for (int position = n - 1; position >= 0; position--) {
+    const graphNode v = queue.popMin();
+    order[position] = v;
+    for (graphNode u : graph.neighbors(v)) {
+      if (queue.contains(u)) queue.decrement(u);
+    }
+  }
+  return order;
+}
+
+std::vector<graphNode> incidenceDegree(const CSRGraph &graph) {
+  const int n = graph.numVertices();
+  BucketQueue queue(std::vector<int>(n, 0));
+  std::vector<graphNode> order;
+  order.reserve(n);
+
+  // Seed with a largest-degree vertex; later ties keep the queue's order
+  graphNode v = n > 0 ? 0 : -1;
+  for (int u = 1; u < n; u++) {
+    if (graph.degree(u) > graph.degree(v)) v = u;
+  }
+  if (v >= 0) queue.remove(v);
+
+  while (v >= 0) {
+    order.push_back(v);
+    for (graphNode u : graph.neighbors(v)) {
+      if (queue.contains(u)) queue.increment(u);
+    }
+    v = queue.popMax();
+  }
+  return order;
+}
+
+std::vector<graphNode> parallelSmallestLast(const CSRGraph &graph) {
+  const int n = graph.numVertices();
+  std::vector<int> degree = degrees(graph);
+  std::vector<int> round(n, -1);  // Round that peeled the vertex
+  std::vector<graphNode> remaining(n);
+  std::vector<char> peeling(n, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v < n; v++) {
+    remaining[v] = v;
+  }
+
+  int rounds = 0;
+  while (!remaining.empty()) {
+    const int count = static_cast<int>(remaining.size());
+    long long degree_sum = 0;
+    #pragma omp parallel for schedule(static) reduction(+ : degree_sum)
+    for (int i = 0; i < count; i++) {
+      degree_sum += degree[remaining[i]];
+    }
+    const double threshold = (1 + PARALLEL_SL_EPSILON) * degree_sum / count;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+      const graphNode v = remaining[i];
+      peeling[v] = degree[v] <= threshold;
+    }
+
+    // Peeled vertices leave together, so only the survivors lose degree
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < count; i++) {
+      const graphNode v = remaining[i];
+      if (!peeling[v]) continue;
+      round[v] = rounds;
+      for (graphNode u : graph.neighbors(v)) {
+        if (!peeling[u] && round[u] < 0) {
+          #pragma omp atomic
+          degree[u]--;
+        }
+      }
+    }
+
+    remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                   [&peeling](graphNode v) { return peeling[v] != 0; }),
+                    remaining.end());
+    rounds++;
+  }
+
+  // Last round first; vertices of a round stay in id order
+  std::vector<int> starts(rounds + 1, 0);
+  for (int v = 0; v < n; v++) starts[rounds - round[v]]++;
+  for (int r = 0; r < rounds; r++) starts[r + 1] += starts[r];
+  std::vector<graphNode> order(n);
+  for (int v = 0; v < n; v++) order[starts[rounds - 1 - round[v]]++] = v;
+  return order;
+}
+
+} // namespace
+
+const char *coloringOrderName(ColoringOrder order) {
+  switch (order) {
+  case ColoringOrder::LargestFirst:
+    return "largest";
+  case ColoringOrder::SmallestLast:
+    return "sl";
+  case ColoringOrder::IncidenceDegree:
+    return "id";
+  case ColoringOrder::ParallelSmallestLast:
+    break;
+  }
+  return "psl";
+}
+
+bool parseColoringOrder(const std::string &name, ColoringOrder &order) {
+  for (ColoringOrder candidate : {ColoringOrder::LargestFirst, ColoringOrder::SmallestLast,
+                                  ColoringOrder::IncidenceDegree,
+                                  ColoringOrder::ParallelSmallestLast}) {
+    if (name == coloringOrderName(candidate)) {
+      order = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<graphNode> computeColoringOrder(const CSRGraph &graph, ColoringOrder order) {
+  switch (order) {
+  case ColoringOrder::LargestFirst:
+    return largestFirst(graph);
+  case ColoringOrder::SmallestLast:
+    return smallestLast(graph);
+  case ColoringOrder::IncidenceDegree:
+    return incidenceDegree(graph);
+  case ColoringOrder::ParallelSmallestLast:
+    break;
+  }
+  return parallelSmallestLast(graph);
+}
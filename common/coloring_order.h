@@ -0,0 +1,70 @@
+/**
+ * @file coloring_order.h
+ * @brief Vertex orderings for greedy coloring, selectable for every engine
+ *
+ *  - largest:  largest degree first, by counting sort.
+ *  - sl:       smallest-last (degeneracy) ordering: repeatedly remove a
+ *              vertex of minimum remaining degree, then color in reverse
+ *              removal order. Greedy coloring in this order uses at most
+ *              degeneracy + 1 colors.
+ *  - id:       incidence degree: start from a vertex of largest degree,
+ *              then repeatedly take the vertex with the most neighbors
+ *              already ordered.
+ *  - psl:      parallel approximate smallest-last. Each round peels, in
+ *              parallel, every vertex whose remaining degree is at most
+ *              (1 + PARALLEL_SL_EPSILON) times the round's average, so the
+ *              graph shrinks geometrically in O(log V) rounds. Rounds are
+ *              colored last-peeled first.
+ *
+ * sl and id run in O(V + E) on a BucketQueue.
+ *
+ * Engines pick their own order by default: natural order for the id-based
+ * ones, largest-first for the others. A driver that wants another order
+ * relabels the graph so that vertex ids follow it (see ReorderedGraph) and
+ * sets PresetColoringOrder, which tells the engines that sort by degree to
+ * take the ids as they are.
+ */
+
+#ifndef COLORING_ORDER_H
+#define COLORING_ORDER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "csr_graph.h"
+
+enum class ColoringOrder { LargestFirst, SmallestLast, IncidenceDegree, ParallelSmallestLast };
+
+constexpr double PARALLEL_SL_EPSILON = 0.5;
+
+const char *coloringOrderName(ColoringOrder order);
+
+/**
+ * @brief Parses largest, sl, id or psl
+ *
+ * @return False for any other name
+ */
+bool parseColoringOrder(const std::string &name, ColoringOrder &order);
+
+/**
+ * @brief Every vertex once, in the order greedy coloring should visit them
+ */
+std::vector<graphNode> computeColoringOrder(const CSRGraph &graph, ColoringOrder order);
+
+/**
+ * @brief Whether vertex ids already are the coloring order
+ *
+ * Set by the drivers around runs on a graph relabeled into a chosen order;
+ * the engines that would sort by degree keep the id order instead.
+ */
+class PresetColoringOrder {
+public:
+  static bool active() { return active_flag.load(std::memory_order_relaxed); }
+  static void setActive(bool active) { active_flag.store(active, std::memory_order_relaxed); }
+
+private:
+  static std::atomic<bool> active_flag;
+};
+
+#endif // COLORING_ORDER_H
@@ -0,0 +1,109 @@
+#include "coloring_validator.h"
+
+#include <algorithm>
+#include <omp.h>
+
+ColoringReport validateColoring(const CSRGraph &graph, const std::vector<color> &colors) {
+  ColoringReport report;
+  const int vertices = graph.numVertices();
+  if (colors.size() != static_cast<size_t>(vertices)) {
+    report.size_mismatch = true;
+    return report;
+  }
+
+  const CSRGraph::edgeIndex *offsets = graph.offsetData();
+  const graphNode *adjacency = graph.adjacencyData();
+  const color *vertex_colors = colors.data();
+
+  uint64_t conflicts = 0;
+  uint64_t self_loops = 0;
+  int64_t uncolored = 0;
+  color max_color = -1;
+  // Smallest offending vertex, so the reported example does not depend on scheduling
+  graphNode first_conflict = vertices;
+
+  #pragma omp parallel for schedule(dynamic, 1024) \
+      reduction(+ : conflicts, self_loops, uncolored) reduction(max : max_color) \
+      reduction(min : first_conflict)
+  for (int v = 0; v < vertices; v++) {
+    const color c = vertex_colors[v];
+    if (c < 0) uncolored++;
+    max_color = std::max(max_color, c);
+
+    for (CSRGraph::edgeIndex e = offsets[v]; e < offsets[v + 1]; e++) {
+      const graphNode u = adjacency[e];
+      if (u == v) {
+        self_loops++;
+        first_conflict = std::min(first_conflict, v);
+      } else if (u > v && vertex_colors[u] == c) {
+        conflicts++;
+        first_conflict = std::min(first_conflict, v);
+      }
+    }
+  }
+
+  report.conflicting_edges = conflicts;
+  report.self_loops = self_loops;
+  report.uncolored_vertices = uncolored;
+  report.max_color = max_color;
+
+  if (first_conflict < vertices) {
+    report.conflict_u = first_conflict;
+    for (graphNode u : graph.neighbors(first_conflict)) {
+      if (u >= first_conflict && colors[u] == colors[first_conflict]) {
+        report.conflict_v = u;
+        break;
+      }
+    }
+  }
+
+  // Color class histogram from per-thread counts
+  if (max_color >= 0) {
+    const int num_colors = max_color + 1;
+    report.class_sizes.assign(num_colors, 0);
+
+    #pragma omp parallel
+    {
+      std::vector<int64_t> local_sizes(num_colors, 0);
+      #pragma omp for schedule(static) nowait
+      for (int v = 0; v < vertices; v++) {
+        if (vertex_colors[v] >= 0) local_sizes[vertex_colors[v]]++;
+      }
+      #pragma omp critical
+      for (int c = 0; c < num_colors; c++) {
+        report.class_sizes[c] += local_sizes[c];
+      }
+    }
+  }
+
+  return report;
+}
+
+void printColoringReport(std::ostream &out, const ColoringReport &report, bool histogram) {
+  if (report.size_mismatch) {
+    out << "Validation: coloring does not cover every vertex" << std::endl;
+    return;
+  }
+
+  out << "Validation: " << report.conflicting_edges << " conflicting edges, "
+      << report.uncolored_vertices << " uncolored vertices, max color " << report.max_color;
+  if (report.self_loops > 0) {
+    out << ", " << report.self_loops << " self-loops";
+  }
+  out << std::endl;
+
+  if (report.conflict_u >= 0) {
+    out << "  e.g. edge (" << report.conflict_u << ", " << report.conflict_v
+        << ") has both endpoints colored the same" << std::endl;
+  }
+
+  if (histogram && !report.class_sizes.empty()) {
+    int64_t smallest = *std::min_element(report.class_sizes.begin(), report.class_sizes.end());
+    int64_t largest = *std::max_element(report.class_sizes.begin(), report.class_sizes.end());
+    out << "Color classes: " << report.class_sizes.size() << " (smallest " << smallest
+        << ", largest " << largest << ")" << std::endl;
+    for (size_t c = 0; c < report.class_sizes.size(); c++) {
+      out << "  color " << c << ": " << report.class_sizes[c] << std::endl;
+    }
+  }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file coloring_validator.h
+ * @brief Parallel check of a dense coloring against a CSR graph
+ *
+ * One OpenMP pass over the adjacency arrays counts conflicting edges and
+ * uncolored vertices, and a second pass over the colors builds the color
+ * class histogram from per-thread counts. Both are plain array scans, so
+ * validating costs a fraction of any coloring run.
+ */
+
+#ifndef COLORING_VALIDATOR_H
+#define COLORING_VALIDATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "csr_graph.h"
+
+struct ColoringReport {
+  uint64_t conflicting_edges = 0;  // Edges u < v with color(u) == color(v)
+  uint64_t self_loops = 0;         // Adjacency entries (v, v); no coloring satisfies these
+  int64_t uncolored_vertices = 0;  // Vertices with a negative color
+  bool size_mismatch = false;      // colors.size() != numVertices(); nothing else was checked
+  color max_color = -1;
+  std::vector<int64_t> class_sizes;  // class_sizes[c] = vertices with color c
+  // One offending edge, or (-1, -1) if there is none
+  graphNode conflict_u = -1;
+  graphNode conflict_v = -1;
+
+  int numColors() const { return max_color + 1; }
+  bool valid() const {
+    return !size_mismatch && conflicting_edges == 0 && self_loops == 0 && uncolored_vertices == 0;
+  }
+};
+
+/**
+ * @brief Validates colors, indexed by vertex id, against graph
+ */
+ColoringReport validateColoring(const CSRGraph &graph, const std::vector<color> &colors);
+
+/**
+ * @brief Prints the report; the color class histogram only on request
+ */
+void printColoringReport(std::ostream &out, const ColoringReport &report, bool histogram = false);
+
+#endif // COLORING_VALIDATOR_H
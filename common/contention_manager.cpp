@@ -0,0 +1,95 @@
+#include "contention_manager.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+const char *contentionPolicyName(ContentionPolicy policy) {
+  switch (policy) {
+  case ContentionPolicy::Backoff:
+    return "backoff";
+  case ContentionPolicy::Karma:
+    return "karma";
+  case ContentionPolicy::Adaptive:
+    break;
+  }
+  return "adaptive";
+}
+
+ContentionPolicy contentionPolicyFromEnv() {
+  const char *name = std::getenv("TXN_CONTENTION");
+  if (name && std::strcmp(name, "backoff") == 0) return ContentionPolicy::Backoff;
+  if (name && std::strcmp(name, "karma") == 0) return ContentionPolicy::Karma;
+  return ContentionPolicy::Adaptive;
+}
+
+void ContentionManager::Thread::backoff(int attempt, uint64_t karma,
+                                        TxnTelemetry::Thread *telemetry) {
+  // Every doubling of lost work halves the wait, up to 16x
+  int shift = 0;
+  if (manager->contention_policy != ContentionPolicy::Backoff) {
+    for (uint64_t k = karma / 16; k > 0 && shift < 4; k >>= 1) shift++;
+  }
+
+  if (!telemetry) {
+    jitter.pause(attempt, shift);
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  jitter.pause(attempt, shift);
+  telemetry->addBackoff(
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+bool ContentionManager::Thread::arbitrates() const {
+  return manager->contention_policy != ContentionPolicy::Backoff;
+}
+
+void ContentionManager::Thread::finished(int aborts, int degree) {
+  if (manager->contention_policy != ContentionPolicy::Adaptive) return;
+
+  // Lock-path callers report 0 aborts, so the average decays while on it
+  abort_rate += RATE_WEIGHT * ((aborts > 0 ? 1.0 : 0.0) - abort_rate);
+  if (on_lock_path) {
+    lock_path_transactions++;
+    if (abort_rate < LEAVE_LOCK_RATE) on_lock_path = false;
+  } else if (abort_rate > ENTER_LOCK_RATE) {
+    on_lock_path = true;
+    lock_path_switches++;
+  }
+
+  DegreeRate &rate = manager->degree_rates[TxnTelemetry::degreeBucket(degree)];
+  rate.transactions.fetch_add(1, std::memory_order_relaxed);
+  if (aborts > 0) rate.retried.fetch_add(1, std::memory_order_relaxed);
+}
+
+ContentionManager::ContentionManager(ContentionPolicy policy, int num_threads)
+    : contention_policy(policy), threads(num_threads > 0 ? num_threads : 1) {
+  for (Thread &t : threads) t.manager = this;
+}
+
+bool ContentionManager::isHotDegree(int degree, bool fallback_guess) const {
+  if (contention_policy != ContentionPolicy::Adaptive) return fallback_guess;
+
+  const DegreeRate &rate = degree_rates[TxnTelemetry::degreeBucket(degree)];
+  uint64_t transactions = rate.transactions.load(std::memory_order_relaxed);
+  if (transactions < MIN_DEGREE_SAMPLES) return fallback_guess;
+  return rate.retried.load(std::memory_order_relaxed) > ENTER_LOCK_RATE * transactions;
+}
+
+void ContentionManager::printSummary(std::ostream &out) const {
+  uint64_t switches = 0;
+  uint64_t lock_path = 0;
+  double mean_rate = 0;
+  for (const Thread &t : threads) {
+    switches += t.lock_path_switches;
+    lock_path += t.lock_path_transactions;
+    mean_rate += t.abort_rate / threads.size();
+  }
+  out << "Contention manager: " << contentionPolicyName(contention_policy);
+  if (contention_policy == ContentionPolicy::Adaptive) {
+    out << ", " << switches << " switches to the lock path, " << lock_path
+        << " lock-path transactions, mean retry rate " << mean_rate;
+  }
+  out << std::endl;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file contention_manager.h
+ * @brief Per-thread retry policy for the HTM and STM engines
+ *
+ * Three policies, chosen with TXN_CONTENTION=backoff|karma|adaptive:
+ *  - backoff:  randomized exponential backoff between attempts.
+ *  - karma:    the same wait, shortened by the work the transaction has
+ *              already lost to aborts. STMs with per-word locks also
+ *              arbitrate on it: a transaction that meets a lock held by
+ *              one with less karma kills the holder instead of aborting.
+ *  - adaptive: karma waits and arbitration, plus a per-thread moving
+ *              average of how many transactions needed a retry. Above
+ *              ENTER_LOCK_RATE the thread runs its transactions on the
+ *              engine's lock path until the average decays below
+ *              LEAVE_LOCK_RATE. A shared per-degree table of the same
+ *              rate tells the HTM engine which vertices are worth
+ *              speculating on.
+ *
+ * Each thread owns one cache-line-aligned slot; only the degree table is
+ * shared, and it is updated with relaxed atomics.
+ */
+
+#ifndef CONTENTION_MANAGER_H
+#define CONTENTION_MANAGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "csr_graph.h"
+#include "txn_telemetry.h"
+
+enum class ContentionPolicy { Backoff, Karma, Adaptive };
+
+const char *contentionPolicyName(ContentionPolicy policy);
+
+/**
+ * @brief Policy named by TXN_CONTENTION; adaptive when unset or unknown
+ */
+ContentionPolicy contentionPolicyFromEnv();
+
+/**
+ * @brief Randomized exponential backoff shared by every policy
+ */
+class RandomizedBackoff {
+public:
+  /**
+   * @brief Waits before retry number attempt (1-based); shift shortens the wait by 2^shift
+   */
+  void pause(int attempt, int shift = 0) {
+    if (attempt > 16) {
+      std::this_thread::yield();
+      return;
+    }
+    if (seed == 0) {
+      static std::atomic<uint64_t> next_seed{0x9e3779b97f4a7c15ULL};
+      seed = next_seed.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed) | 1;
+    }
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+
+    uint64_t spins = (seed & ((uint64_t(1) << std::min(attempt + 4, 14)) - 1)) >> shift;
+    for (volatile uint64_t i = 0; i < spins; i++) {
+    }
+  }
+
+private:
+  uint64_t seed = 0;
+};
+
+class ContentionManager {
+public:
+  // Moving average weight of one transaction, and the lock-path hysteresis
+  static constexpr double RATE_WEIGHT = 1.0 / 32;
+  static constexpr double ENTER_LOCK_RATE = 0.25;
+  static constexpr double LEAVE_LOCK_RATE = 0.05;
+
+  class alignas(CACHE_LINE_SIZE) Thread {
+  public:
+    /**
+     * @brief True if the next transaction should skip speculation (adaptive only)
+     */
+    bool preferLock() const { return on_lock_path; }
+
+    /**
+     * @brief True if lock conflicts should be settled by karma (karma and adaptive)
+     */
+    bool arbitrates() const;
+
+    /**
+     * @brief Waits after an aborted attempt
+     *
+     * @param karma Work lost so far by this transaction, e.g. words read by its aborted attempts
+     */
+    void backoff(int attempt, uint64_t karma, TxnTelemetry::Thread *telemetry);
+
+    /**
+     * @brief Feeds a finished transaction into the abort-rate average
+     *
+     * Transactions run on the lock path report 0 aborts whatever their
+     * retries, or a thread could never get back below LEAVE_LOCK_RATE.
+     */
+    void finished(int aborts, int degree);
+
+    double abortRate() const { return abort_rate; }
+
+  private:
+    friend class ContentionManager;
+
+    ContentionManager *manager = nullptr;
+    RandomizedBackoff jitter;
+    double abort_rate = 0;
+    bool on_lock_path = false;
+    uint64_t lock_path_switches = 0;
+    uint64_t lock_path_transactions = 0;
+  };
+
+  ContentionManager(ContentionPolicy policy, int num_threads);
+
+  ContentionManager(const ContentionManager &) = delete;
+  ContentionManager &operator=(const ContentionManager &) = delete;
+
+  Thread &thread(int id) { return threads[id]; }
+  ContentionPolicy policy() const { return contention_policy; }
+
+  /**
+   * @brief Whether vertices of this degree abort too often to speculate on
+   *
+   * Adaptive only, and only once the degree's bucket has enough samples;
+   * until then, and under the other policies, fallback_guess decides.
+   */
+  bool isHotDegree(int degree, bool fallback_guess) const;
+
+  /**
+   * @brief One line: policy, lock-path switches and transactions, mean abort rate
+   */
+  void printSummary(std::ostream &out) const;
+
+private:
+  struct DegreeRate {
+    std::atomic<uint64_t> transactions{0};
+    std::atomic<uint64_t> retried{0};
+  };
+
+  static const uint64_t MIN_DEGREE_SAMPLES = 64;
+
+  ContentionPolicy contention_policy;
+  std::vector<Thread> threads;
+  DegreeRate degree_rates[TxnTelemetry::NUM_DEGREE_BUCKETS];
+};
+
+#endif // CONTENTION_MANAGER_H
@@ -0,0 +1,222 @@
+#include "csr_graph.h"
+
+#include <algorithm>
+#include <omp.h>
+
+CSRGraph::CSRGraph(int vertices, AlignedVector<edgeIndex> &&offsets,
+                   AlignedVector<graphNode> &&adjacency)
+    : num_vertices(vertices), offsets(std::move(offsets)), adjacency(std::move(adjacency)) {
+  bindOwnedStorage();
+}
+
+CSRGraph::CSRGraph(int vertices, const edgeIndex *offsets, const graphNode *adjacency,
+                   std::shared_ptr<const void> backing)
+    : num_vertices(vertices), offset_view(offsets), adjacency_view(adjacency),
+      backing(std::move(backing)) {}
+
+CSRGraph::CSRGraph(const CSRGraph &other)
+    : num_vertices(other.num_vertices), offsets(other.offsets), adjacency(other.adjacency),
+      backing(other.backing) {
+  bindStorageOf(other);
+}
+
+CSRGraph::CSRGraph(CSRGraph &&other) noexcept
+    : num_vertices(other.num_vertices), offsets(std::move(other.offsets)),
+      adjacency(std::move(other.adjacency)), backing(std::move(other.backing)) {
+  bindStorageOf(other);
+  other.clear();
+}
+
+CSRGraph &CSRGraph::operator=(const CSRGraph &other) {
+  if (this != &other) {
+    num_vertices = other.num_vertices;
+    offsets = other.offsets;
+    adjacency = other.adjacency;
+    backing = other.backing;
+    bindStorageOf(other);
+  }
+  return *this;
+}
+
+CSRGraph &CSRGraph::operator=(CSRGraph &&other) noexcept {
+  if (this != &other) {
+    num_vertices = other.num_vertices;
+    offsets = std::move(other.offsets);
+    adjacency = std::move(other.adjacency);
+    backing = std::move(other.backing);
+    bindStorageOf(other);
+    other.clear();
+  }
+  return *this;
+}
+
+/**
+ * @brief Leaves a moved-from graph as a valid empty graph
+ */
+void CSRGraph::clear() {
+  num_vertices = 0;
+  offsets.assign(1, 0);
+  adjacency.clear();
+  backing.reset();
+  bindOwnedStorage();
+}
+
+/**
+ * @brief Points the views at our own vectors, or shares other's external arrays
+ */
+void CSRGraph::bindStorageOf(const CSRGraph &other) {
+  if (backing) {
+    offset_view = other.offset_view;
+    adjacency_view = other.adjacency_view;
+  } else {
+    bindOwnedStorage();
+  }
+}
+
+/**
+ * @brief In-place inclusive prefix sum, one contiguous block per thread
+ */
+void CSRGraph::prefixSum(edgeIndex *values, size_t count) {
+  std::vector<edgeIndex> block_sums(omp_get_max_threads() + 1, 0);
+
+  #pragma omp parallel
+  {
+    int thread_id = omp_get_thread_num();
+    int num_threads = omp_get_num_threads();
+    size_t begin = count * thread_id / num_threads;
+    size_t end = count * (thread_id + 1) / num_threads;
+
+    edgeIndex sum = 0;
+    for (size_t i = begin; i < end; i++) {
+      sum += values[i];
+      values[i] = sum;
+    }
+    block_sums[thread_id + 1] = sum;
+
+    #pragma omp barrier
+    #pragma omp single
+    for (int t = 1; t <= num_threads; t++) {
+      block_sums[t] += block_sums[t - 1];
+    }
+
+    edgeIndex base = block_sums[thread_id];
+    if (base != 0) {
+      for (size_t i = begin; i < end; i++) {
+        values[i] += base;
+      }
+    }
+  }
+}
+
+CSRGraph CSRGraph::fromEdges(int vertices,
+                             const std::vector<std::pair<graphNode, graphNode>> &edges,
+                             const CSRBuildOptions &options) {
+  const size_t EDGES_PER_CHUNK = 1 << 16;
+  const size_t num_chunks = (edges.size() + EDGES_PER_CHUNK - 1) / EDGES_PER_CHUNK;
+
+  return fromEdgeSource(vertices, num_chunks, [&edges, EDGES_PER_CHUNK](size_t chunk, auto &&emit) {
+    size_t end = std::min(edges.size(), (chunk + 1) * EDGES_PER_CHUNK);
+    for (size_t i = chunk * EDGES_PER_CHUNK; i < end; i++) {
+      emit(edges[i].first, edges[i].second);
+    }
+  }, options);
+}
+
+CSRGraph CSRGraph::finishRows(int vertices, AlignedVector<edgeIndex> &&offsets,
+                              AlignedVector<graphNode> &&adjacency,
+                              AlignedVector<edgeIndex> &cursor, const CSRBuildOptions &options) {
+  if (!options.sort_neighbors && !options.remove_duplicates) {
+    return CSRGraph(vertices, std::move(offsets), std::move(adjacency));
+  }
+
+  // Sort every row, reusing the cursor array for the deduplicated degree
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (int v = 0; v < vertices; v++) {
+    graphNode *row_begin = adjacency.data() + offsets[v];
+    graphNode *row_end = adjacency.data() + offsets[v + 1];
+    std::sort(row_begin, row_end);
+    if (options.remove_duplicates) {
+      cursor[v] = std::unique(row_begin, row_end) - row_begin;
+    }
+  }
+
+  if (!options.remove_duplicates) {
+    return CSRGraph(vertices, std::move(offsets), std::move(adjacency));
+  }
+
+  // Compact the unique prefix of every row into a fresh neighbor array
+  AlignedVector<edgeIndex> unique_offsets(vertices + 1);
+  unique_offsets[0] = 0;
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v < vertices; v++) {
+    unique_offsets[v + 1] = cursor[v];
+  }
+  prefixSum(unique_offsets.data(), unique_offsets.size());
+
+  AlignedVector<graphNode> unique_adjacency(unique_offsets[vertices]);
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (int v = 0; v < vertices; v++) {
+    std::copy(adjacency.begin() + offsets[v], adjacency.begin() + offsets[v] + cursor[v],
+              unique_adjacency.begin() + unique_offsets[v]);
+  }
+
+  return CSRGraph(vertices, std::move(unique_offsets), std::move(unique_adjacency));
+}
+
+CSRGraph CSRGraph::relabeled(const std::vector<graphNode> &new_ids) const {
+  std::vector<graphNode> old_ids(num_vertices);
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v < num_vertices; v++) {
+    old_ids[new_ids[v]] = v;
+  }
+
+  AlignedVector<edgeIndex> new_offsets(num_vertices + 1);
+  new_offsets[0] = 0;
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v < num_vertices; v++) {
+    new_offsets[v + 1] = degree(old_ids[v]);
+  }
+  prefixSum(new_offsets.data(), new_offsets.size());
+
+  AlignedVector<graphNode> new_adjacency(new_offsets[num_vertices]);
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (int v = 0; v < num_vertices; v++) {
+    graphNode *row = new_adjacency.data() + new_offsets[v];
+    for (graphNode u : neighbors(old_ids[v])) {
+      *row++ = new_ids[u];
+    }
+    std::sort(new_adjacency.data() + new_offsets[v], row);
+  }
+
+  return CSRGraph(num_vertices, std::move(new_offsets), std::move(new_adjacency));
+}
+
+CSRGraph CSRGraph::fromAdjacencyMap(
+    const std::unordered_map<graphNode, std::vector<graphNode>> &graph) {
+  int vertices = static_cast<int>(graph.size());
+
+  AlignedVector<edgeIndex> offsets(vertices + 1, 0);
+  for (const auto &entry : graph) {
+    offsets[entry.first + 1] = entry.second.size();
+  }
+  for (int v = 0; v < vertices; v++) {
+    offsets[v + 1] += offsets[v];
+  }
+
+  AlignedVector<graphNode> adjacency(offsets[vertices]);
+  for (const auto &entry : graph) {
+    std::copy(entry.second.begin(), entry.second.end(), adjacency.begin() + offsets[entry.first]);
+  }
+
+  return CSRGraph(vertices, std::move(offsets), std::move(adjacency));
+}
+
+void CSRGraph::toAdjacencyMap(
+    std::unordered_map<graphNode, std::vector<graphNode>> &graph) const {
+  graph.clear();
+  graph.reserve(num_vertices);
+  for (int v = 0; v < num_vertices; v++) {
+    auto row = neighbors(v);
+    graph[v].assign(row.begin(), row.end());
+  }
+}
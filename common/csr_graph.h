@@ -0,0 +1,262 @@
+/**
+ * @file csr_graph.h
+ * @brief Immutable compressed-sparse-row graph shared by every coloring engine
+ *
+ * The drivers build one CSRGraph per input and hand it to the engines by const
+ * reference, so no engine has to copy a map-of-vectors adjacency into its own
+ * vector layout before it can start coloring. Vertex ids are dense 32-bit
+ * integers in [0, numVertices()), and the offsets and neighbor arrays are
+ * allocated on cache-line boundaries.
+ *
+ * A graph either owns its arrays or views arrays kept alive by a shared backing
+ * object, which is how the binary loader serves a graph straight out of a file
+ * mapping without copying it.
+ */
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+typedef int graphNode;
+typedef int color;
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Allocator returning cache-line aligned storage
+ *
+ * Sized construction default-initializes instead of zeroing, so the parallel
+ * builders can first-touch large arrays from the threads that will use them.
+ */
+template <typename T>
+struct CacheAlignedAllocator {
+  typedef T value_type;
+
+  CacheAlignedAllocator() = default;
+  template <typename U>
+  CacheAlignedAllocator(const CacheAlignedAllocator<U> &) {}
+
+  T *allocate(size_t n) {
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, CACHE_LINE_SIZE, n * sizeof(T)) != 0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, size_t) { free(ptr); }
+
+  template <typename U>
+  void construct(U *ptr) {
+    ::new (static_cast<void *>(ptr)) U;
+  }
+  template <typename U, typename... Args>
+  void construct(U *ptr, Args &&...args) {
+    ::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const CacheAlignedAllocator<T> &, const CacheAlignedAllocator<U> &) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const CacheAlignedAllocator<T> &, const CacheAlignedAllocator<U> &) {
+  return false;
+}
+
+template <typename T>
+using AlignedVector = std::vector<T, CacheAlignedAllocator<T>>;
+
+/**
+ * @brief Clean-up applied while building a CSRGraph from an edge list
+ */
+struct CSRBuildOptions {
+  bool sort_neighbors = false;     // Ascending neighbor ids in every row
+  bool remove_duplicates = false;  // Collapse repeated edges, implies sorting
+  bool remove_self_loops = false;  // Drop edges (v, v)
+};
+
+class CSRGraph {
+public:
+  typedef uint64_t edgeIndex;
+
+  /**
+   * @brief Lightweight view over the neighbors of one vertex
+   */
+  class NeighborRange {
+  public:
+    NeighborRange(const graphNode *first, const graphNode *last) : first(first), last(last) {}
+    const graphNode *begin() const { return first; }
+    const graphNode *end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    graphNode operator[](size_t i) const { return first[i]; }
+
+  private:
+    const graphNode *first;
+    const graphNode *last;
+  };
+
+  CSRGraph() : num_vertices(0), offsets(1, 0) { bindOwnedStorage(); }
+  CSRGraph(int vertices, AlignedVector<edgeIndex> &&offsets, AlignedVector<graphNode> &&adjacency);
+
+  /**
+   * @brief Views externally stored arrays without copying them
+   *
+   * @param vertices Number of vertices
+   * @param offsets vertices + 1 row starts
+   * @param adjacency offsets[vertices] neighbor ids
+   * @param backing Owner of both arrays, released with the last graph viewing them
+   */
+  CSRGraph(int vertices, const edgeIndex *offsets, const graphNode *adjacency,
+           std::shared_ptr<const void> backing);
+
+  CSRGraph(const CSRGraph &other);
+  CSRGraph(CSRGraph &&other) noexcept;
+  CSRGraph &operator=(const CSRGraph &other);
+  CSRGraph &operator=(CSRGraph &&other) noexcept;
+
+  /**
+   * @brief Builds an undirected graph; every edge is stored in both endpoint rows
+   *
+   * Runs as an OpenMP degree histogram, prefix sum and scatter, followed by an
+   * optional per-row sort and deduplication. Without sorting, the order of
+   * neighbors inside a row depends on thread scheduling.
+   *
+   * @param vertices Number of vertices; edges with an endpoint outside
+   *                 [0, vertices) are skipped
+   * @param edges Edge list
+   * @param options Row clean-up to apply
+   */
+  static CSRGraph fromEdges(int vertices, const std::vector<std::pair<graphNode, graphNode>> &edges,
+                            const CSRBuildOptions &options = CSRBuildOptions());
+
+  /**
+   * @brief Builds the graph from a chunked edge producer without materializing an edge list
+   *
+   * The source is invoked as source(chunk, emit) for every chunk in [0, num_chunks),
+   * concurrently from several threads, and must call emit(u, v) once per edge of that
+   * chunk. Every chunk is visited twice, once for the degree histogram and once for
+   * the scatter, so the source has to produce the same edges on both visits.
+   */
+  template <typename EdgeSource>
+  static CSRGraph fromEdgeSource(int vertices, size_t num_chunks, const EdgeSource &source,
+                                 const CSRBuildOptions &options = CSRBuildOptions());
+
+  /**
+   * @brief Compatibility adapter for the old map-of-vectors adjacency
+   *
+   * Vertex ids are taken as-is, so the map must cover [0, graph.size()).
+   */
+  static CSRGraph fromAdjacencyMap(const std::unordered_map<graphNode, std::vector<graphNode>> &graph);
+  void toAdjacencyMap(std::unordered_map<graphNode, std::vector<graphNode>> &graph) const;
+
+  /**
+   * @brief Copy of the graph with vertex v renamed to new_ids[v]
+   *
+   * new_ids must be a permutation of [0, numVertices()). Rows come out sorted,
+   * so neighbors are visited in the new layout's memory order.
+   */
+  CSRGraph relabeled(const std::vector<graphNode> &new_ids) const;
+
+  int numVertices() const { return num_vertices; }
+  // Number of stored adjacency entries, i.e. twice the undirected edge count
+  edgeIndex numAdjacencies() const { return offset_view[num_vertices]; }
+
+  int degree(graphNode vertex) const {
+    return static_cast<int>(offset_view[vertex + 1] - offset_view[vertex]);
+  }
+
+  NeighborRange neighbors(graphNode vertex) const {
+    return NeighborRange(adjacency_view + offset_view[vertex],
+                         adjacency_view + offset_view[vertex + 1]);
+  }
+
+  const edgeIndex *offsetData() const { return offset_view; }
+  const graphNode *adjacencyData() const { return adjacency_view; }
+
+private:
+  static void prefixSum(edgeIndex *values, size_t count);
+  static CSRGraph finishRows(int vertices, AlignedVector<edgeIndex> &&offsets,
+                             AlignedVector<graphNode> &&adjacency, AlignedVector<edgeIndex> &cursor,
+                             const CSRBuildOptions &options);
+  void bindOwnedStorage() {
+    offset_view = offsets.data();
+    adjacency_view = adjacency.data();
+  }
+  void bindStorageOf(const CSRGraph &other);
+  void clear();
+
+  int num_vertices;
+  AlignedVector<edgeIndex> offsets;
+  AlignedVector<graphNode> adjacency;
+  // Every accessor reads through these; they point into the vectors above or into backing
+  const edgeIndex *offset_view;
+  const graphNode *adjacency_view;
+  std::shared_ptr<const void> backing;
+};
+
+template <typename EdgeSource>
+CSRGraph CSRGraph::fromEdgeSource(int vertices, size_t num_chunks, const EdgeSource &source,
+                                  const CSRBuildOptions &options) {
+  auto keepEdge = [vertices, &options](graphNode u, graphNode v) {
+    return u >= 0 && u < vertices && v >= 0 && v < vertices &&
+           !(options.remove_self_loops && u == v);
+  };
+
+  // Degree histogram, shifted by one so the prefix sum yields row starts
+  AlignedVector<edgeIndex> offsets(vertices + 1);
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v <= vertices; v++) {
+    offsets[v] = 0;
+  }
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    source(chunk, [&](graphNode u, graphNode v) {
+      if (!keepEdge(u, v)) return;
+      #pragma omp atomic
+      offsets[u + 1]++;
+      #pragma omp atomic
+      offsets[v + 1]++;
+    });
+  }
+
+  prefixSum(offsets.data(), offsets.size());
+
+  // Scatter both directions of every edge through per-row cursors
+  AlignedVector<graphNode> adjacency(offsets[vertices]);
+  AlignedVector<edgeIndex> cursor(vertices);
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v < vertices; v++) {
+    cursor[v] = offsets[v];
+  }
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    source(chunk, [&](graphNode u, graphNode v) {
+      if (!keepEdge(u, v)) return;
+      edgeIndex slot;
+      #pragma omp atomic capture
+      slot = cursor[u]++;
+      adjacency[slot] = v;
+      #pragma omp atomic capture
+      slot = cursor[v]++;
+      adjacency[slot] = u;
+    });
+  }
+
+  return finishRows(vertices, std::move(offsets), std::move(adjacency), cursor, options);
+}
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,121 @@
+/**
+ * @file forbidden_colors.h
+ * @brief Per-thread set of colors taken by a vertex's neighbors
+ *
+ * Every engine colors a vertex by marking its neighbors' colors and taking
+ * the smallest unmarked one. ForbiddenColors keeps the marks as 64-bit words
+ * with one epoch stamp per word: clear() only bumps the epoch, and a word
+ * whose stamp is stale reads as empty, so no per-vertex memset is needed
+ * however many colors the graph uses. The first free color is found by a
+ * trailing-zero count over the inverted words, four words per step with AVX2.
+ */
+
+#ifndef FORBIDDEN_COLORS_H
+#define FORBIDDEN_COLORS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "csr_graph.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+class ForbiddenColors {
+public:
+  /**
+   * @param capacity Number of colors to size for up front; marks beyond it grow the set
+   */
+  explicit ForbiddenColors(int capacity = 256)
+      : bits(wordsFor(capacity), 0), stamps(wordsFor(capacity), 0), epoch(1), used_words(0) {}
+
+  /**
+   * @brief Instance owned by the calling thread, for engines without their own
+   */
+  static ForbiddenColors &local() {
+    static thread_local ForbiddenColors instance;
+    return instance;
+  }
+
+  /**
+   * @brief Empties the set in O(1)
+   */
+  void clear() {
+    epoch++;
+    used_words = 0;
+  }
+
+  /**
+   * @brief Marks c as taken; negative colors (uncolored neighbors) are ignored
+   */
+  void forbid(color c) {
+    if (c < 0) return;
+    size_t word = static_cast<size_t>(c) >> 6;
+    if (word >= bits.size()) grow(word + 1);
+    if (stamps[word] != epoch) {
+      stamps[word] = epoch;
+      bits[word] = 0;
+    }
+    bits[word] |= uint64_t(1) << (c & 63);
+    if (word >= used_words) used_words = word + 1;
+  }
+
+  bool isForbidden(color c) const {
+    if (c < 0) return false;
+    size_t word = static_cast<size_t>(c) >> 6;
+    return word < used_words && (liveWord(word) >> (c & 63)) & 1;
+  }
+
+  /**
+   * @brief Smallest color that has not been forbidden since the last clear()
+   */
+  color firstAvailable() const {
+    size_t word = 0;
+#ifdef __AVX2__
+    const __m256i current = _mm256_set1_epi64x(static_cast<long long>(epoch));
+    const __m256i full = _mm256_set1_epi64x(-1);
+    for (; word + 4 <= used_words; word += 4) {
+      __m256i live = _mm256_cmpeq_epi64(
+          _mm256_load_si256(reinterpret_cast<const __m256i *>(stamps.data() + word)), current);
+      __m256i marks = _mm256_and_si256(
+          live, _mm256_load_si256(reinterpret_cast<const __m256i *>(bits.data() + word)));
+      int full_lanes = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(marks, full)));
+      if (full_lanes != 0xF) {
+        word += __builtin_ctz(~full_lanes & 0xF);
+        break;
+      }
+    }
+#endif
+    for (; word < used_words; word++) {
+      uint64_t free_bits = ~liveWord(word);
+      if (free_bits != 0) {
+        return static_cast<color>(word * 64 + __builtin_ctzll(free_bits));
+      }
+    }
+    return static_cast<color>(used_words * 64);
+  }
+
+private:
+  static size_t wordsFor(int colors) {
+    // Whole 256-bit blocks keep the AVX2 loads aligned and in bounds
+    size_t words = (static_cast<size_t>(colors > 0 ? colors : 1) + 63) / 64;
+    return (words + 3) & ~size_t(3);
+  }
+
+  uint64_t liveWord(size_t word) const { return stamps[word] == epoch ? bits[word] : 0; }
+
+  void grow(size_t words) {
+    size_t target = wordsFor(static_cast<int>(std::min<size_t>(words * 2 * 64, INT32_MAX)));
+    bits.resize(target, 0);
+    stamps.resize(target, 0);
+  }
+
+  AlignedVector<uint64_t> bits;
+  AlignedVector<uint64_t> stamps;
+  uint64_t epoch;
+  size_t used_words;  // Words below this may hold marks of the current epoch
+};
+
+#endif // FORBIDDEN_COLORS_H
@@ -0,0 +1,188 @@
+#include "graph_loader.h"
+#include "binary_graph.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <omp.h>
+
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+namespace {
+
+// Byte ranges handed out per thread; more ranges than threads keeps the
+// dynamic schedule balanced when line lengths vary across the file
+constexpr int RANGES_PER_THREAD = 8;
+
+inline bool isDigit(char c) { return static_cast<unsigned>(c - '0') < 10; }
+
+inline void skipBlanks(const char *&pos, const char *end) {
+  while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) pos++;
+}
+
+inline void skipLine(const char *&pos, const char *end) {
+  const void *newline = memchr(pos, '\n', end - pos);
+  pos = newline ? static_cast<const char *>(newline) + 1 : end;
+}
+
+/**
+ * @brief Number of consecutive decimal digits starting at pos
+ *
+ * With SSE4.2 a whole 16-byte block is classified by one PCMPISTRI range
+ * compare; the scalar loop handles the tail of the mapping.
+ */
+inline int digitRun(const char *pos, const char *end) {
+#ifdef __SSE4_2__
+  if (end - pos >= 16) {
+    const __m128i digit_range = _mm_setr_epi8('0', '9', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    int run = _mm_cmpistri(digit_range, block,
+                           _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY);
+    if (run < 16) return run;
+  }
+#endif
+  const char *scan = pos;
+  while (scan < end && isDigit(*scan)) scan++;
+  return static_cast<int>(scan - pos);
+}
+
+/**
+ * @brief Parses a non-negative int at pos, advancing past its digits
+ */
+inline bool parseNumber(const char *&pos, const char *end, int &value) {
+  int digits = digitRun(pos, end);
+  if (digits == 0 || digits > 10) return false;
+
+  uint64_t result = 0;
+  for (int i = 0; i < digits; i++) {
+    result = result * 10 + static_cast<unsigned>(pos[i] - '0');
+  }
+  if (result > static_cast<uint64_t>(INT_MAX)) return false;
+
+  pos += digits;
+  value = static_cast<int>(result);
+  return true;
+}
+
+/**
+ * @brief Parses one line and moves pos to the start of the next one
+ *
+ * @return How many integers lead the line, 0 for blank and comment lines,
+ *         -1 for lines that do not start with a non-negative integer
+ */
+inline int parseLine(const char *&pos, const char *end, int &first, int &second) {
+  skipBlanks(pos, end);
+  int count = 0;
+  if (pos < end && *pos != '\n' && *pos != '#' && *pos != '%') {
+    count = -1;
+    if (parseNumber(pos, end, first)) {
+      count = 1;
+      skipBlanks(pos, end);
+      if (parseNumber(pos, end, second)) count = 2;
+    }
+  }
+  skipLine(pos, end);
+  return count;
+}
+
+/**
+ * @brief Moves pos forward to the first byte of a line
+ */
+const char *alignToLine(const char *pos, const char *begin, const char *end) {
+  if (pos <= begin) return begin;
+  if (pos >= end) return end;
+  if (pos[-1] == '\n') return pos;
+  const void *newline = memchr(pos, '\n', end - pos);
+  return newline ? static_cast<const char *>(newline) + 1 : end;
+}
+
+} // namespace
+
+bool loadEdgeList(const std::string &fileName, CSRGraph &graph, const CSRBuildOptions &options) {
+  MappedFile file(fileName);
+  if (!file.isOpen()) {
+    return false;
+  }
+
+  const char *begin = file.data();
+  const char *end = begin + file.size();
+
+  // The first data line is either the vertex count or already an edge
+  const char *body = begin;
+  long long vertices = -1;
+  while (body < end) {
+    const char *line = body;
+    int first, second;
+    int count = parseLine(body, end, first, second);
+    if (count == 1) {
+      vertices = first;
+      break;
+    }
+    if (count == 2) {
+      body = line;
+      break;
+    }
+  }
+
+  int num_threads = omp_get_max_threads();
+  size_t num_ranges = static_cast<size_t>(num_threads) * RANGES_PER_THREAD;
+  std::vector<const char *> bounds(num_ranges + 1);
+  size_t body_size = end - body;
+  for (size_t r = 0; r <= num_ranges; r++) {
+    bounds[r] = alignToLine(body + body_size * r / num_ranges, body, end);
+  }
+
+  std::atomic<size_t> skipped_lines{0};
+  auto parseRange = [&](size_t range, auto &&emit) {
+    const char *pos = bounds[range];
+    const char *range_end = bounds[range + 1];
+    size_t skipped = 0;
+    while (pos < range_end) {
+      int u, v;
+      int count = parseLine(pos, range_end, u, v);
+      if (count == 2) {
+        emit(u, v);
+      } else if (count != 0) {
+        skipped++;
+      }
+    }
+    if (skipped > 0) skipped_lines.fetch_add(skipped, std::memory_order_relaxed);
+  };
+
+  if (vertices < 0) {
+    // No vertex-count line: size the graph from the largest id
+    int max_id = -1;
+    #pragma omp parallel for schedule(dynamic, 1) reduction(max : max_id)
+    for (size_t range = 0; range < num_ranges; range++) {
+      parseRange(range, [&max_id](int u, int v) { max_id = std::max(max_id, std::max(u, v)); });
+    }
+    if (max_id < 0) {
+      return false;
+    }
+    vertices = static_cast<long long>(max_id) + 1;
+    skipped_lines.store(0);
+  }
+
+  graph = CSRGraph::fromEdgeSource(static_cast<int>(vertices), num_ranges, parseRange, options);
+
+  // Both builder passes parse every range, so each bad line was counted twice
+  size_t skipped = skipped_lines.load() / 2;
+  if (skipped > 0) {
+    std::cerr << "Warning: skipped " << skipped << " malformed lines in " << fileName << std::endl;
+  }
+  return true;
+}
+
+bool loadGraph(const std::string &fileName, CSRGraph &graph, const CSRBuildOptions &options) {
+  if (isBinaryGraphFile(fileName)) {
+    return loadBinaryGraph(fileName, graph);
+  }
+  return loadEdgeList(fileName, graph, options);
+}
@@ -0,0 +1,43 @@
+/**
+ * @file graph_loader.h
+ * @brief Shared text edge-list loader used by every driver
+ *
+ * The file is memory-mapped, split into per-thread byte ranges aligned on line
+ * boundaries and parsed in parallel straight into the CSR builder; no
+ * intermediate edge vector is materialized.
+ *
+ * Accepted format: an optional first line holding only the vertex count,
+ * followed by one "u v" pair per line. Lines starting with '#' or '%' are
+ * comments. Without a vertex-count line the graph gets max id + 1 vertices.
+ */
+
+#ifndef GRAPH_LOADER_H
+#define GRAPH_LOADER_H
+
+#include <string>
+
+#include "csr_graph.h"
+
+/**
+ * @brief Loads a text edge list into a CSR graph
+ *
+ * @param fileName Path of the edge list
+ * @param graph Output graph
+ * @param options Row clean-up applied by the CSR builder
+ * @return False if the file cannot be opened or holds no vertex count or edges
+ */
+bool loadEdgeList(const std::string &fileName, CSRGraph &graph,
+                  const CSRBuildOptions &options = CSRBuildOptions());
+
+/**
+ * @brief Loads either a binary graph (see binary_graph.h) or a text edge list
+ *
+ * The format is detected from the file's magic bytes. Binary graphs are mapped
+ * as written, so options only apply to text input.
+ *
+ * @return False if the file cannot be opened or parsed
+ */
+bool loadGraph(const std::string &fileName, CSRGraph &graph,
+               const CSRBuildOptions &options = CSRBuildOptions());
+
+#endif // GRAPH_LOADER_H
@@ -0,0 +1,134 @@
+#include "iterated_greedy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+#include "forbidden_colors.h"
+#include "phase_timer.h"
+
+namespace {
+
+// Classes smaller than this are recolored by the calling thread alone
+const int PARALLEL_CLASS_SIZE = 1024;
+
+enum class ClassOrder { Reverse, LargestFirst, Random };
+
+} // namespace
+
+RecolorStats recolorIteratedGreedy(const CSRGraph &graph, std::vector<color> &colors,
+                                   const RecolorOptions &options) {
+  PhaseTimer::Scope phase(Phase::Recolor);
+  const auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&start]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  RecolorStats stats;
+  const int n = graph.numVertices();
+  if (static_cast<int>(colors.size()) != n) return stats;
+  int num_colors = 0;
+  for (int v = 0; v < n; v++) {
+    if (colors[v] < 0) return stats;
+    num_colors = std::max(num_colors, colors[v] + 1);
+  }
+  stats.initial_colors = num_colors;
+  stats.final_colors = num_colors;
+  stats.applied = true;
+
+  std::vector<color> next(n);
+  std::vector<graphNode> members(n);
+  std::vector<int> class_start;
+  std::vector<int> class_order;
+  std::mt19937_64 rng(options.seed);
+  int passes_without_gain = 0;
+
+  while (stats.passes < options.max_passes && passes_without_gain < options.patience &&
+         elapsed() < options.time_budget_seconds) {
+    // Group the vertices by class, keeping id order inside a class
+    class_start.assign(num_colors + 1, 0);
+    for (int v = 0; v < n; v++) class_start[colors[v] + 1]++;
+    for (int c = 0; c < num_colors; c++) class_start[c + 1] += class_start[c];
+    std::vector<int> cursor(class_start.begin(), class_start.end() - 1);
+    for (int v = 0; v < n; v++) members[cursor[colors[v]]++] = v;
+
+    class_order.resize(num_colors);
+    std::iota(class_order.begin(), class_order.end(), 0);
+    switch (static_cast<ClassOrder>(stats.passes % 3)) {
+    case ClassOrder::Reverse:
+      std::reverse(class_order.begin(), class_order.end());
+      break;
+    case ClassOrder::LargestFirst:
+      std::stable_sort(class_order.begin(), class_order.end(), [&class_start](int a, int b) {
+        return class_start[a + 1] - class_start[a] > class_start[b + 1] - class_start[b];
+      });
+      break;
+    case ClassOrder::Random:
+      std::shuffle(class_order.begin(), class_order.end(), rng);
+      break;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < n; v++) {
+      next[v] = -1;
+    }
+
+    // Only the input can have a conflict; every pass's output is proper. A
+    // self-loop is one too, as in the validator: no coloring can satisfy it
+    const bool check_conflicts = stats.passes == 0;
+    std::atomic<bool> conflict{false};
+    for (int c : class_order) {
+      const int begin = class_start[c];
+      const int end = class_start[c + 1];
+      #pragma omp parallel for schedule(dynamic, 256) if (end - begin >= PARALLEL_CLASS_SIZE)
+      for (int i = begin; i < end; i++) {
+        const graphNode v = members[i];
+        ForbiddenColors &forbidden = ForbiddenColors::local();
+        forbidden.clear();
+        for (graphNode u : graph.neighbors(v)) {
+          if (check_conflicts && colors[u] == c) conflict.store(true, std::memory_order_relaxed);
+          forbidden.forbid(next[u]);
+        }
+        next[v] = forbidden.firstAvailable();
+      }
+      if (conflict.load(std::memory_order_relaxed)) break;
+    }
+    if (conflict.load(std::memory_order_relaxed)) {
+      stats.applied = false;
+      stats.seconds = elapsed();
+      return stats;
+    }
+
+    int next_colors = 0;
+    #pragma omp parallel for schedule(static) reduction(max : next_colors)
+    for (int v = 0; v < n; v++) {
+      next_colors = std::max(next_colors, next[v] + 1);
+    }
+
+    colors.swap(next);
+    stats.passes++;
+    passes_without_gain = next_colors < num_colors ? 0 : passes_without_gain + 1;
+    num_colors = next_colors;
+  }
+
+  stats.final_colors = num_colors;
+  stats.seconds = elapsed();
+  return stats;
+}
+
+void printRecolorStats(std::ostream &out, const RecolorStats &stats) {
+  if (!stats.applied) {
+    out << "Recoloring skipped: the engine's coloring is incomplete or has conflicts" << std::endl;
+    return;
+  }
+  out << "Recolored: " << stats.initial_colors << " -> " << stats.final_colors << " colors in "
+      << stats.passes << " passes (" << stats.seconds << " s)" << std::endl;
+}
+
+void RecoloredColorGraph::colorGraph(const CSRGraph &graph, std::vector<color> &colors) {
+  engine->colorGraph(graph, colors);
+  printRecolorStats(std::cout, recolorIteratedGreedy(graph, colors, options));
+}
@@ -0,0 +1,73 @@
+/**
+ * @file iterated_greedy.h
+ * @brief Culberson's iterated greedy recoloring, as a post-pass for any engine
+ *
+ * Greedy coloring that visits the vertices class by class never needs more
+ * colors than there are classes: a vertex can always reuse the color its
+ * whole class got, since no earlier class is adjacent to all of it. Each
+ * pass therefore keeps or lowers the color count, and shuffling the class
+ * order between passes lets it escape the poor choices the first coloring
+ * made. Passes rotate through three class orders: reverse (highest color
+ * first), largest class first, and random.
+ *
+ * A color class is an independent set, so its vertices are recolored in
+ * parallel; each one only reads neighbors from classes already done.
+ */
+
+#ifndef ITERATED_GREEDY_H
+#define ITERATED_GREEDY_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "color_graph.h"
+#include "csr_graph.h"
+
+struct RecolorOptions {
+  double time_budget_seconds = 1.0;  // No pass starts after this much time
+  int max_passes = 1000;
+  int patience = 12;  // Consecutive passes without fewer colors before stopping
+  uint64_t seed = 1;  // For the random class orders
+};
+
+struct RecolorStats {
+  int initial_colors = 0;
+  int final_colors = 0;
+  int passes = 0;
+  double seconds = 0;
+  bool applied = false;  // False if the input was not a complete proper coloring
+};
+
+/**
+ * @brief Lowers the color count of a complete proper coloring in place
+ *
+ * Inputs with uncolored vertices, conflicting edges or self-loops are left unchanged,
+ * with applied false, so a broken engine still fails validation.
+ */
+RecolorStats recolorIteratedGreedy(const CSRGraph &graph, std::vector<color> &colors,
+                                   const RecolorOptions &options = RecolorOptions());
+
+/**
+ * @brief One line: colors before and after, passes and time
+ */
+void printRecolorStats(std::ostream &out, const RecolorStats &stats);
+
+/**
+ * @brief Runs an engine, then recolors its result
+ */
+class RecoloredColorGraph : public ColorGraph {
+public:
+  RecoloredColorGraph(std::unique_ptr<ColorGraph> engine, const RecolorOptions &options)
+      : engine(std::move(engine)), options(options) {}
+
+  void colorGraph(const CSRGraph &graph, std::vector<color> &colors) override;
+  using ColorGraph::colorGraph;
+
+private:
+  std::unique_ptr<ColorGraph> engine;
+  RecolorOptions options;
+};
+
+#endif // ITERATED_GREEDY_H
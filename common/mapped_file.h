@@ -0,0 +1,57 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory mapping of a whole file
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class MappedFile {
+public:
+  /**
+   * @brief Maps fileName read-only; check isOpen() for failure
+   */
+  explicit MappedFile(const std::string &fileName) : mapped(nullptr), length(0) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) return;
+
+    struct stat sb;
+    if (fstat(fd, &sb) == 0 && sb.st_size > 0) {
+      void *ptr = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (ptr != MAP_FAILED) {
+        mapped = ptr;
+        length = static_cast<size_t>(sb.st_size);
+        // Every loader thread reads its own range, so ask for read-ahead up front
+        madvise(mapped, length, MADV_WILLNEED);
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (mapped != nullptr) {
+      munmap(mapped, length);
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool isOpen() const { return mapped != nullptr; }
+  const char *data() const { return static_cast<const char *>(mapped); }
+  size_t size() const { return length; }
+
+private:
+  void *mapped;
+  size_t length;
+};
+
+#endif // MAPPED_FILE_H
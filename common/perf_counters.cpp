@@ -0,0 +1,278 @@
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct EventConfig {
+  uint32_t type;
+  uint64_t config;
+  bool supported;  // Opened on the first thread; later threads skip the rest
+};
+
+struct ThreadCounters {
+  int fds[NUM_PERF_EVENTS];
+  bool opened = false;  // The group leader opened, so the slot has counts to report
+  std::atomic<bool> active{false};  // Counted by readAll(): in the current run, or ran a phase
+  bool closed = false;  // The thread exited; final_counts holds its last reading
+  PerfCounts final_counts;
+
+  ThreadCounters() {
+    for (int &fd : fds) fd = -1;
+  }
+
+  ~ThreadCounters() { closeEvents(); }
+
+  void closeEvents() {
+    for (int &fd : fds) {
+      if (fd >= 0) close(fd);
+      fd = -1;
+    }
+  }
+};
+
+std::atomic<bool> counters_enabled{false};
+std::string unavailable_reason = "counters were not enabled";
+EventConfig events[NUM_PERF_EVENTS];
+
+// Slots outlive their threads, like the phase timer's, so a worker that
+// exits before the run ends is still summed; only its fds are closed
+std::mutex threads_mutex;
+std::vector<std::unique_ptr<ThreadCounters>> threads;
+
+int openEvent(const EventConfig &event, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+// RTM aborts, from the event the kernel's cpu PMU exports, e.g. "event=0xc9,umask=0x4"
+bool txAbortEvent(EventConfig &event) {
+  std::ifstream type_file("/sys/bus/event_source/devices/cpu/type");
+  std::ifstream event_file("/sys/bus/event_source/devices/cpu/events/tx-abort");
+  if (!type_file || !event_file) return false;
+
+  std::string terms;
+  std::getline(event_file, terms);
+  uint64_t code = 0;
+  uint64_t umask = 0;
+  std::stringstream stream(terms);
+  std::string term;
+  while (std::getline(stream, term, ',')) {
+    size_t eq = term.find('=');
+    if (eq == std::string::npos) return false;
+    std::string key = term.substr(0, eq);
+    uint64_t value = std::strtoull(term.c_str() + eq + 1, nullptr, 0);
+    if (key == "event") {
+      code = value;
+    } else if (key == "umask") {
+      umask = value;
+    } else {
+      return false;  // Other fields are not encoded here
+    }
+  }
+  type_file >> event.type;
+  event.config = code | (umask << 8);
+  return true;
+}
+
+// Scaled for the time the group was multiplexed off the PMU
+uint64_t readCounter(int fd) {
+  uint64_t values[3];  // value, time enabled, time running
+  if (fd < 0 || read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0) return 0;
+  if (values[1] == values[2]) return values[0];
+  return static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+}
+
+PerfCounts readCounters(const ThreadCounters &counters) {
+  if (counters.closed) return counters.final_counts;
+  PerfCounts counts;
+  for (int e = 0; e < NUM_PERF_EVENTS; e++) counts.values[e] = readCounter(counters.fds[e]);
+  return counts;
+}
+
+// Freezes the thread's counts and closes its fds when the thread exits
+struct ThreadExit {
+  ThreadCounters *counters = nullptr;
+
+  ~ThreadExit() {
+    if (!counters) return;
+    std::lock_guard<std::mutex> guard(threads_mutex);
+    counters->final_counts = readCounters(*counters);
+    counters->closed = true;
+    counters->closeEvents();
+  }
+};
+
+ThreadCounters &localCounters() {
+  static thread_local ThreadExit exit_hook;
+  static thread_local ThreadCounters *local = nullptr;
+  if (local) return *local;
+
+  std::unique_ptr<ThreadCounters> counters(new ThreadCounters());
+  // Cycles leads the group so every event is scheduled onto the PMU together
+  const int leader = openEvent(events[0], -1);
+  counters->fds[0] = leader;
+  counters->opened = leader >= 0;
+  for (int e = 1; leader >= 0 && e < NUM_PERF_EVENTS; e++) {
+    if (events[e].supported) counters->fds[e] = openEvent(events[e], leader);
+  }
+
+  std::lock_guard<std::mutex> guard(threads_mutex);
+  threads.push_back(std::move(counters));
+  local = threads.back().get();
+  exit_hook.counters = local;
+  return *local;
+}
+
+// Restarts the thread's counts and adds it to readAll(). It was not in any
+// earlier readAll() sum, so run deltas only see what it counts from here on.
+void activate(ThreadCounters &counters) {
+  if (counters.active.load(std::memory_order_relaxed)) return;
+  if (counters.fds[0] >= 0) ioctl(counters.fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  counters.active.store(true, std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char *perfEventName(PerfEvent event) {
+  switch (event) {
+  case PerfEvent::Cycles:
+    return "cycles";
+  case PerfEvent::Instructions:
+    return "instructions";
+  case PerfEvent::LLCMisses:
+    return "llc_misses";
+  case PerfEvent::BranchMisses:
+    return "branch_misses";
+  case PerfEvent::TxAborts:
+    break;
+  }
+  return "tx_aborts";
+}
+
+PerfCounts &PerfCounts::operator+=(const PerfCounts &other) {
+  for (int e = 0; e < NUM_PERF_EVENTS; e++) values[e] += other.values[e];
+  return *this;
+}
+
+PerfCounts PerfCounts::operator-(const PerfCounts &other) const {
+  PerfCounts difference;
+  for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+    difference.values[e] = values[e] >= other.values[e] ? values[e] - other.values[e] : 0;
+  }
+  return difference;
+}
+
+bool PerfCounters::enable() {
+  if (counters_enabled.load(std::memory_order_relaxed)) return true;
+
+  events[static_cast<int>(PerfEvent::Cycles)] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true};
+  events[static_cast<int>(PerfEvent::Instructions)] = {PERF_TYPE_HARDWARE,
+                                                       PERF_COUNT_HW_INSTRUCTIONS, true};
+  events[static_cast<int>(PerfEvent::LLCMisses)] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,
+                                                    true};
+  events[static_cast<int>(PerfEvent::BranchMisses)] = {PERF_TYPE_HARDWARE,
+                                                       PERF_COUNT_HW_BRANCH_MISSES, true};
+  EventConfig &tx_aborts = events[static_cast<int>(PerfEvent::TxAborts)];
+  tx_aborts.supported = txAbortEvent(tx_aborts);
+
+  // Probe each event alone, so one the PMU lacks does not take the group down
+  for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+    if (!events[e].supported) continue;
+    int fd = openEvent(events[e], -1);
+    if (fd < 0) {
+      if (e == 0) {
+        unavailable_reason = std::string("perf_event_open: ") + strerror(errno);
+        return false;
+      }
+      events[e].supported = false;
+      continue;
+    }
+    close(fd);
+  }
+
+  counters_enabled.store(true, std::memory_order_relaxed);
+  activate(localCounters());
+  return true;
+}
+
+bool PerfCounters::enabled() { return counters_enabled.load(std::memory_order_relaxed); }
+
+const std::string &PerfCounters::unavailableReason() { return unavailable_reason; }
+
+bool PerfCounters::available(PerfEvent event) {
+  return enabled() && events[static_cast<int>(event)].supported;
+}
+
+void PerfCounters::attachOpenMPThreads() {
+  if (!enabled()) return;
+  {
+    // Idle pool threads from a wider earlier run would only add spin-wait counts
+    std::lock_guard<std::mutex> guard(threads_mutex);
+    threads.erase(std::remove_if(threads.begin(), threads.end(),
+                                 [](const std::unique_ptr<ThreadCounters> &counters) {
+                                   return counters->closed;
+                                 }),
+                  threads.end());
+    for (const auto &counters : threads) counters->active.store(false, std::memory_order_relaxed);
+  }
+  #pragma omp parallel
+  activate(localCounters());
+}
+
+PerfCounts PerfCounters::readThread() {
+  if (!enabled()) return PerfCounts();
+  ThreadCounters &counters = localCounters();
+  activate(counters);
+  return readCounters(counters);
+}
+
+PerfCounts PerfCounters::readAll() {
+  PerfCounts total;
+  if (!enabled()) return total;
+  std::lock_guard<std::mutex> guard(threads_mutex);
+  for (const auto &counters : threads) {
+    // Threads whose group never opened, or that sat out this run, would dilute the sum
+    if (!counters->opened || !counters->active.load(std::memory_order_relaxed)) continue;
+    total += readCounters(*counters);
+  }
+  return total;
+}
+
+void PerfCounters::printSummary(std::ostream &out, const PerfCounts &counts, uint64_t edges) {
+  const uint64_t cycles = counts[PerfEvent::Cycles];
+  const double per_edge = edges > 0 ? 1.0 / edges : 0;
+  out << "Counters: " << cycles << " cycles, " << counts[PerfEvent::Instructions]
+      << " instructions (IPC "
+      << (cycles > 0 ? static_cast<double>(counts[PerfEvent::Instructions]) / cycles : 0) << ")";
+  if (available(PerfEvent::LLCMisses)) {
+    out << ", " << counts[PerfEvent::LLCMisses] << " LLC misses ("
+        << counts[PerfEvent::LLCMisses] * per_edge << " per edge)";
+  }
+  if (available(PerfEvent::BranchMisses)) {
+    out << ", " << counts[PerfEvent::BranchMisses] << " branch misses ("
+        << counts[PerfEvent::BranchMisses] * per_edge << " per edge)";
+  }
+  if (available(PerfEvent::TxAborts)) out << ", " << counts[PerfEvent::TxAborts] << " RTM aborts";
+  out << std::endl;
+}
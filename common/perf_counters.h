@@ -0,0 +1,76 @@
+/**
+ * @file perf_counters.h
+ * @brief Per-thread hardware counters read through perf_event_open
+ *
+ * Every thread that is measured opens its own counter group: cycles,
+ * instructions, LLC misses and branch misses, plus RTM aborts when the
+ * kernel exports the cpu/tx-abort event. Counters only count user space, so
+ * they work under the default perf_event_paranoid setting. A thread's counts
+ * can be read by itself, or summed from serial code over the active threads:
+ * those attached for the current run and any that ran a phase since. OpenMP
+ * pool threads keep their groups across runs; a thread's fds are closed when
+ * it exits, and its last counts stay readable until the next run attaches.
+ *
+ * Nothing is opened until a driver calls enable(). On machines without a
+ * PMU (most VMs) enable() fails once with the reason, and drivers carry on
+ * without counters.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+enum class PerfEvent : int { Cycles, Instructions, LLCMisses, BranchMisses, TxAborts };
+constexpr int NUM_PERF_EVENTS = 5;
+
+const char *perfEventName(PerfEvent event);
+
+struct PerfCounts {
+  uint64_t values[NUM_PERF_EVENTS] = {};
+
+  uint64_t operator[](PerfEvent event) const { return values[static_cast<int>(event)]; }
+  PerfCounts &operator+=(const PerfCounts &other);
+  PerfCounts operator-(const PerfCounts &other) const;
+};
+
+class PerfCounters {
+public:
+  /**
+   * @brief Opens counters on the calling thread; false (see unavailableReason()) without a PMU
+   */
+  static bool enable();
+  static bool enabled();
+  static const std::string &unavailableReason();
+
+  /**
+   * @brief Whether the event could be opened; TxAborts needs RTM and the tx-abort event
+   */
+  static bool available(PerfEvent event);
+
+  /**
+   * @brief Makes the next OpenMP parallel region's threads the only active ones
+   *
+   * Opens counters on threads that have none and drops the slots of exited threads.
+   */
+  static void attachOpenMPThreads();
+
+  /**
+   * @brief Counts of the calling thread since it became active, activating it if needed
+   */
+  static PerfCounts readThread();
+
+  /**
+   * @brief Sum over the active threads; call from serial code
+   */
+  static PerfCounts readAll();
+
+  /**
+   * @brief One line: the counts, IPC, and misses per edge
+   */
+  static void printSummary(std::ostream &out, const PerfCounts &counts, uint64_t edges);
+};
+
+#endif // PERF_COUNTERS_H
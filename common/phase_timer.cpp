@@ -0,0 +1,147 @@
+#include "phase_timer.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <omp.h>
+#include <vector>
+
+std::atomic<bool> PhaseTimer::enabled_flag{false};
+
+namespace {
+
+struct alignas(CACHE_LINE_SIZE) Slot {
+  double seconds[NUM_PHASES] = {};
+  uint64_t scopes[NUM_PHASES] = {};
+  PerfCounts counts[NUM_PHASES];
+};
+
+// Slots outlive their threads, so OpenMP pool threads keep theirs across runs
+std::mutex slots_mutex;
+std::vector<std::unique_ptr<Slot>> slots;
+
+Slot &localSlot() {
+  static thread_local Slot *slot = nullptr;
+  if (!slot) {
+    std::lock_guard<std::mutex> guard(slots_mutex);
+    slots.emplace_back(new Slot());
+    slot = slots.back().get();
+  }
+  return *slot;
+}
+
+} // namespace
+
+const char *phaseName(Phase phase) {
+  switch (phase) {
+  case Phase::Setup:
+    return "setup";
+  case Phase::Ordering:
+    return "ordering";
+  case Phase::Partition:
+    return "partition";
+  case Phase::Precolor:
+    return "precolor";
+  case Phase::Color:
+    return "color";
+  case Phase::ConflictDetection:
+    return "conflict detection";
+  case Phase::ConflictResolution:
+    return "conflict resolution";
+  case Phase::Recolor:
+    return "recolor";
+  case Phase::Output:
+    break;
+  }
+  return "output";
+}
+
+bool PhaseTotals::any() const {
+  for (int p = 0; p < NUM_PHASES; p++) {
+    if (threads[p] > 0) return true;
+  }
+  return false;
+}
+
+void PhaseTimer::reset() {
+  std::lock_guard<std::mutex> guard(slots_mutex);
+  for (auto &slot : slots) *slot = Slot();
+}
+
+void PhaseTimer::add(Phase phase, double seconds, const PerfCounts &counts) {
+  Slot &slot = localSlot();
+  slot.seconds[static_cast<int>(phase)] += seconds;
+  slot.scopes[static_cast<int>(phase)]++;
+  slot.counts[static_cast<int>(phase)] += counts;
+}
+
+PhaseTotals PhaseTimer::totals() {
+  PhaseTotals totals;
+  std::lock_guard<std::mutex> guard(slots_mutex);
+  for (const auto &slot : slots) {
+    for (int p = 0; p < NUM_PHASES; p++) {
+      if (slot->scopes[p] == 0) continue;
+      totals.wall_seconds[p] = std::max(totals.wall_seconds[p], slot->seconds[p]);
+      totals.cpu_seconds[p] += slot->seconds[p];
+      totals.threads[p]++;
+      totals.counts[p] += slot->counts[p];
+    }
+  }
+  return totals;
+}
+
+void PhaseTimer::printSummary(std::ostream &out, const PhaseTotals &totals) {
+  out << "Phases:";
+  bool first = true;
+  for (int p = 0; p < NUM_PHASES; p++) {
+    if (totals.threads[p] == 0) continue;
+    out << (first ? " " : ", ") << phaseName(static_cast<Phase>(p)) << " "
+        << totals.wall_seconds[p];
+    if (totals.threads[p] > 1) {
+      out << " (" << totals.cpu_seconds[p] << " over " << totals.threads[p] << " threads)";
+    }
+    first = false;
+  }
+  if (first) out << " none recorded";
+  out << std::endl;
+}
+
+void PhaseTimer::printCounters(std::ostream &out, const PhaseTotals &totals, uint64_t edges) {
+  out << "Phase counters:";
+  bool first = true;
+  for (int p = 0; p < NUM_PHASES; p++) {
+    const PerfCounts &counts = totals.counts[p];
+    if (totals.threads[p] == 0 || counts[PerfEvent::Cycles] == 0) continue;
+    out << (first ? " " : ", ") << phaseName(static_cast<Phase>(p)) << " IPC "
+        << static_cast<double>(counts[PerfEvent::Instructions]) / counts[PerfEvent::Cycles];
+    if (edges > 0 && PerfCounters::available(PerfEvent::LLCMisses)) {
+      out << ", " << static_cast<double>(counts[PerfEvent::LLCMisses]) / edges << " LLC misses";
+    }
+    if (edges > 0 && PerfCounters::available(PerfEvent::BranchMisses)) {
+      out << ", " << static_cast<double>(counts[PerfEvent::BranchMisses]) / edges
+          << " branch misses";
+    }
+    first = false;
+  }
+  if (first) out << " none recorded";
+  out << std::endl;
+}
+
+void PhaseTimer::Scope::begin() {
+  if (PerfCounters::enabled()) {
+    all_threads = !omp_in_parallel();
+    start_counts = all_threads ? PerfCounters::readAll() : PerfCounters::readThread();
+  }
+  start = std::chrono::steady_clock::now();
+}
+
+void PhaseTimer::Scope::end() {
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (!PerfCounters::enabled()) {
+    add(phase, seconds);
+    return;
+  }
+  PerfCounts counts = all_threads ? PerfCounters::readAll() : PerfCounters::readThread();
+  add(phase, seconds, counts - start_counts);
+}
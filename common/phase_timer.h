@@ -0,0 +1,103 @@
+/**
+ * @file phase_timer.h
+ * @brief Scoped timers for the phases every coloring engine goes through
+ *
+ * Engines mark their phases with PhaseTimer::Scope, an RAII timer that adds
+ * its elapsed time to a per-thread slot. A scope opened in serial code times
+ * the whole phase, including the parallel loops inside it; one opened inside
+ * a parallel region times each thread's share. Totals keep both the slowest
+ * thread (the phase's contribution to the run) and the sum over threads.
+ *
+ * Timing is off unless a driver enables it (-phases); a disabled scope costs
+ * one relaxed load and never reads the clock. When PerfCounters is enabled
+ * as well, each scope also records the hardware counters over its extent:
+ * a serial scope sums every attached thread, a parallel one its own thread.
+ */
+
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#include "csr_graph.h"
+#include "perf_counters.h"
+
+enum class Phase : int {
+  Setup,               // Allocation, input conversion and per-run state
+  Ordering,            // Degree computation and vertex ordering
+  Partition,           // Assigning vertices or blocks to threads
+  Precolor,            // Sequential coloring ahead of the parallel phase
+  Color,               // Main (tentative) coloring
+  ConflictDetection,   // Finding adjacent vertices with the same color
+  ConflictResolution,  // Recoloring the losers
+  Recolor,             // Post-passes over a complete coloring: color reduction, balancing
+  Output,              // Copying the result into the caller's vector
+};
+constexpr int NUM_PHASES = 9;
+
+const char *phaseName(Phase phase);
+
+struct PhaseTotals {
+  double wall_seconds[NUM_PHASES] = {};  // Slowest thread
+  double cpu_seconds[NUM_PHASES] = {};   // Sum over threads
+  int threads[NUM_PHASES] = {};          // Threads that entered the phase
+  PerfCounts counts[NUM_PHASES];         // Sum over threads; zero without counters
+
+  bool any() const;
+};
+
+class PhaseTimer {
+public:
+  static bool enabled() { return enabled_flag.load(std::memory_order_relaxed); }
+  static void setEnabled(bool enabled) { enabled_flag.store(enabled, std::memory_order_relaxed); }
+
+  /**
+   * @brief Zeroes every thread's slot; call between runs, outside parallel regions
+   */
+  static void reset();
+
+  static void add(Phase phase, double seconds, const PerfCounts &counts = PerfCounts());
+
+  static PhaseTotals totals();
+
+  /**
+   * @brief One line of phases that were entered: slowest thread, and the sum when it differs
+   */
+  static void printSummary(std::ostream &out, const PhaseTotals &totals);
+
+  /**
+   * @brief One line of each counted phase's IPC and, per edge, its LLC and branch misses
+   */
+  static void printCounters(std::ostream &out, const PhaseTotals &totals, uint64_t edges);
+
+  class Scope {
+  public:
+    explicit Scope(Phase phase) : phase(phase), active(enabled()) {
+      if (active) begin();
+    }
+    ~Scope() {
+      if (active) end();
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    void begin();
+    void end();
+
+    Phase phase;
+    bool active;
+    bool all_threads = false;  // Opened in serial code, so counters are read for every thread
+    std::chrono::steady_clock::time_point start;
+    PerfCounts start_counts;
+  };
+
+private:
+  static std::atomic<bool> enabled_flag;
+};
+
+#endif // PHASE_TIMER_H
@@ -0,0 +1,158 @@
+#include "txn_telemetry.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+const char *abortCauseName(AbortCause cause) {
+  switch (cause) {
+  case AbortCause::Conflict:
+    return "conflict";
+  case AbortCause::Capacity:
+    return "capacity";
+  case AbortCause::Explicit:
+    return "explicit";
+  case AbortCause::LockHeld:
+    return "lock_held";
+  case AbortCause::Other:
+    break;
+  }
+  return "other";
+}
+
+uint64_t TxnTelemetry::Thread::totalAborts() const {
+  uint64_t total = 0;
+  for (int c = 0; c < NUM_ABORT_CAUSES; c++) total += aborts[c];
+  return total;
+}
+
+void TxnTelemetry::Thread::add(const Thread &other) {
+  commits += other.commits;
+  fallbacks += other.fallbacks;
+  backoff_seconds += other.backoff_seconds;
+  for (int c = 0; c < NUM_ABORT_CAUSES; c++) aborts[c] += other.aborts[c];
+  for (int b = 0; b < NUM_DEGREE_BUCKETS; b++) {
+    degree_commits[b] += other.degree_commits[b];
+    degree_fallbacks[b] += other.degree_fallbacks[b];
+    for (int c = 0; c < NUM_ABORT_CAUSES; c++) degree_aborts[b][c] += other.degree_aborts[b][c];
+  }
+}
+
+namespace {
+
+TxnTelemetry::Collector *active_collector = nullptr;
+
+} // namespace
+
+TxnTelemetry::TxnTelemetry(const std::string &engine, int num_threads)
+    : engine(engine), threads(num_threads > 0 ? num_threads : 1) {}
+
+int TxnTelemetry::degreeBucket(int degree) {
+  int bucket = 0;
+  while (degree > 0 && bucket < NUM_DEGREE_BUCKETS - 1) {
+    degree >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+TxnTelemetry::Thread TxnTelemetry::totals() const {
+  Thread sum;
+  for (const Thread &t : threads) sum.add(t);
+  return sum;
+}
+
+void TxnTelemetry::printSummary(std::ostream &out) const {
+  Thread sum = totals();
+  out << "Transactions: " << sum.commits << " commits, " << sum.totalAborts() << " aborts (";
+  for (int c = 0; c < NUM_ABORT_CAUSES; c++) {
+    out << (c ? ", " : "") << abortCauseName(static_cast<AbortCause>(c)) << " " << sum.aborts[c];
+  }
+  out << "), " << sum.fallbacks << " fallbacks, " << sum.backoff_seconds << " s in backoff"
+      << std::endl;
+}
+
+namespace {
+
+void writeCauses(std::ostream &out, const uint64_t (&aborts)[NUM_ABORT_CAUSES]) {
+  out << "{";
+  for (int c = 0; c < NUM_ABORT_CAUSES; c++) {
+    out << (c ? ", " : "") << "\"" << abortCauseName(static_cast<AbortCause>(c))
+        << "\": " << aborts[c];
+  }
+  out << "}";
+}
+
+} // namespace
+
+void TxnTelemetry::writeJSON(std::ostream &out) const {
+  Thread sum = totals();
+
+  out << "{\n  \"engine\": \"" << engine << "\",\n  \"threads\": " << threads.size() << ",\n";
+  out << "  \"totals\": {\"commits\": " << sum.commits << ", \"aborts\": " << sum.totalAborts()
+      << ", \"fallbacks\": " << sum.fallbacks << ", \"backoff_seconds\": " << sum.backoff_seconds
+      << ", \"abort_causes\": ";
+  writeCauses(out, sum.aborts);
+  out << "},\n";
+
+  // Empty degree buckets are left out
+  out << "  \"degree_buckets\": [";
+  bool first = true;
+  for (int b = 0; b < NUM_DEGREE_BUCKETS; b++) {
+    uint64_t aborts = 0;
+    for (int c = 0; c < NUM_ABORT_CAUSES; c++) aborts += sum.degree_aborts[b][c];
+    if (sum.degree_commits[b] == 0 && sum.degree_fallbacks[b] == 0 && aborts == 0) continue;
+
+    int64_t min_degree = b == 0 ? 0 : int64_t(1) << (b - 1);
+    int64_t max_degree = b == 0 ? 0 : (int64_t(1) << b) - 1;
+    out << (first ? "\n" : ",\n") << "    {\"min_degree\": " << min_degree
+        << ", \"max_degree\": " << max_degree << ", \"commits\": " << sum.degree_commits[b]
+        << ", \"aborts\": " << aborts << ", \"fallbacks\": " << sum.degree_fallbacks[b]
+        << ", \"abort_causes\": ";
+    writeCauses(out, sum.degree_aborts[b]);
+    out << "}";
+    first = false;
+  }
+  out << "\n  ],\n";
+
+  out << "  \"per_thread\": [";
+  for (size_t t = 0; t < threads.size(); t++) {
+    const Thread &slot = threads[t];
+    out << (t ? ",\n" : "\n") << "    {\"thread\": " << t << ", \"commits\": " << slot.commits
+        << ", \"aborts\": " << slot.totalAborts() << ", \"fallbacks\": " << slot.fallbacks
+        << ", \"backoff_seconds\": " << slot.backoff_seconds << ", \"abort_causes\": ";
+    writeCauses(out, slot.aborts);
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+const char *TxnTelemetry::requestedPath() {
+  const char *path = std::getenv("TXN_TELEMETRY");
+  return path && *path ? path : nullptr;
+}
+
+TxnTelemetry::Collector::Collector() { active_collector = this; }
+
+TxnTelemetry::Collector::~Collector() { active_collector = nullptr; }
+
+void TxnTelemetry::dumpIfRequested() const {
+  if (active_collector) {
+    active_collector->reports().push_back(*this);
+    return;
+  }
+  const char *path = requestedPath();
+  if (!path) return;
+
+  if (std::string(path) == "-") {
+    writeJSON(std::cout);
+    return;
+  }
+  std::ofstream file(path);
+  if (!file) {
+    std::cerr << "Could not write transaction telemetry to " << path << std::endl;
+    return;
+  }
+  writeJSON(file);
+  std::cout << "Transaction telemetry written to " << path << std::endl;
+}
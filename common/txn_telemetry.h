@@ -0,0 +1,120 @@
+/**
+ * @file txn_telemetry.h
+ * @brief Transaction counters by abort cause, vertex degree and thread
+ *
+ * Used by the HTM and STM engines. Each thread owns one cache-line-aligned
+ * slot and updates it with plain stores; totals are only formed after the
+ * parallel region, when the summary is printed or the JSON report written.
+ * Aborts are also bucketed by the degree of the vertex being colored, so
+ * capacity aborts on hubs can be told apart from conflicts on small vertices.
+ */
+
+#ifndef TXN_TELEMETRY_H
+#define TXN_TELEMETRY_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "csr_graph.h"
+
+enum class AbortCause : int {
+  Conflict,  // Data conflict: RTM conflict bit, or an STM read that went stale
+  Capacity,  // RTM read/write set overflow
+  Explicit,  // _xabort from the engine itself
+  LockHeld,  // Fallback lock (HTM) or a word's write-lock (STM) held by another thread
+  Other,     // Interrupts, unsupported instructions and statuses with no cause bit
+};
+constexpr int NUM_ABORT_CAUSES = 5;
+
+const char *abortCauseName(AbortCause cause);
+
+class TxnTelemetry {
+public:
+  // Bucket 0 holds degree 0, bucket b > 0 holds degrees in [2^(b-1), 2^b)
+  static const int NUM_DEGREE_BUCKETS = 24;
+
+  struct alignas(CACHE_LINE_SIZE) Thread {
+    uint64_t commits = 0;
+    uint64_t fallbacks = 0;  // Sections run under a lock instead of a transaction
+    double backoff_seconds = 0;
+    uint64_t aborts[NUM_ABORT_CAUSES] = {};
+    uint64_t degree_commits[NUM_DEGREE_BUCKETS] = {};
+    uint64_t degree_fallbacks[NUM_DEGREE_BUCKETS] = {};
+    uint64_t degree_aborts[NUM_DEGREE_BUCKETS][NUM_ABORT_CAUSES] = {};
+
+    void recordCommit(int degree) {
+      commits++;
+      degree_commits[degreeBucket(degree)]++;
+    }
+    void recordAbort(AbortCause cause, int degree) {
+      aborts[static_cast<int>(cause)]++;
+      degree_aborts[degreeBucket(degree)][static_cast<int>(cause)]++;
+    }
+    void recordFallback(int degree) {
+      fallbacks++;
+      degree_fallbacks[degreeBucket(degree)]++;
+    }
+    void addBackoff(double seconds) { backoff_seconds += seconds; }
+
+    uint64_t totalAborts() const;
+    void add(const Thread &other);
+  };
+
+  TxnTelemetry(const std::string &engine, int num_threads);
+
+  Thread &thread(int id) { return threads[id]; }
+  int numThreads() const { return static_cast<int>(threads.size()); }
+
+  // Sum over every thread
+  Thread totals() const;
+
+  static int degreeBucket(int degree);
+
+  /**
+   * @brief One line of commits, aborts by cause, fallbacks and backoff time
+   */
+  void printSummary(std::ostream &out) const;
+
+  void writeJSON(std::ostream &out) const;
+
+  /**
+   * @brief Writes the JSON report to the file named by TXN_TELEMETRY, "-" for stdout
+   *
+   * While a Collector is alive the report is handed to it instead.
+   */
+  void dumpIfRequested() const;
+
+  /**
+   * @brief TXN_TELEMETRY, or nullptr when it is unset or empty
+   */
+  static const char *requestedPath();
+
+  /**
+   * @brief Takes the reports of engines run while it is alive
+   *
+   * For drivers that run many engines in one process: each engine's
+   * dumpIfRequested() would otherwise overwrite the previous run's file.
+   * Collectors do not nest; create one on the thread that runs the engines.
+   */
+  class Collector {
+  public:
+    Collector();
+    ~Collector();
+
+    Collector(const Collector &) = delete;
+    Collector &operator=(const Collector &) = delete;
+
+    std::vector<TxnTelemetry> &reports() { return collected; }
+
+  private:
+    std::vector<TxnTelemetry> collected;
+  };
+
+private:
+  std::string engine;
+  std::vector<Thread> threads;
+};
+
+#endif // TXN_TELEMETRY_H
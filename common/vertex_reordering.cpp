@@ -0,0 +1,224 @@
+#include "vertex_reordering.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "bucket_queue.h"
+#include "coloring_order.h"
+#include "phase_timer.h"
+
+namespace {
+
+// Vertices by ascending degree, ties in id order
+std::vector<graphNode> verticesByDegree(const CSRGraph &graph) {
+  const int n = graph.numVertices();
+  int max_degree = 0;
+  for (int v = 0; v < n; v++) max_degree = std::max(max_degree, graph.degree(v));
+
+  std::vector<int> starts(max_degree + 2, 0);
+  for (int v = 0; v < n; v++) starts[graph.degree(v) + 1]++;
+  for (int d = 0; d <= max_degree; d++) starts[d + 1] += starts[d];
+
+  std::vector<graphNode> sorted(n);
+  for (int v = 0; v < n; v++) sorted[starts[graph.degree(v)]++] = v;
+  return sorted;
+}
+
+/**
+ * @brief BFS over root's component; returns the last level's minimum-degree vertex
+ *
+ * Vertices are marked with stamp, so consecutive searches never reset seen.
+ */
+graphNode lastLevelMinDegree(const CSRGraph &graph, graphNode root, int stamp,
+                             std::vector<int> &seen, std::vector<graphNode> &queue, int &depth) {
+  queue.clear();
+  queue.push_back(root);
+  seen[root] = stamp;
+  depth = 0;
+  size_t level_begin = 0;
+  while (true) {
+    const size_t level_end = queue.size();
+    for (size_t i = level_begin; i < level_end; i++) {
+      for (graphNode u : graph.neighbors(queue[i])) {
+        if (seen[u] != stamp) {
+          seen[u] = stamp;
+          queue.push_back(u);
+        }
+      }
+    }
+    if (queue.size() == level_end) break;
+    level_begin = level_end;
+    depth++;
+  }
+
+  graphNode best = queue[level_begin];
+  for (size_t i = level_begin; i < queue.size(); i++) {
+    if (graph.degree(queue[i]) < graph.degree(best)) best = queue[i];
+  }
+  return best;
+}
+
+std::vector<graphNode> reverseCuthillMcKee(const CSRGraph &graph) {
+  const int n = graph.numVertices();
+  std::vector<graphNode> order;
+  order.reserve(n);
+  std::vector<char> placed(n, 0);
+  std::vector<int> seen(n, -1);
+  std::vector<graphNode> queue;
+  int stamp = 0;
+
+  auto byDegree = [&graph](graphNode a, graphNode b) {
+    return graph.degree(a) < graph.degree(b) || (graph.degree(a) == graph.degree(b) && a < b);
+  };
+
+  for (graphNode candidate : verticesByDegree(graph)) {
+    if (placed[candidate]) continue;
+
+    // George-Liu: move to the far end of the component while its eccentricity grows
+    graphNode root = candidate;
+    int depth = 0;
+    for (int attempt = 0; attempt < 8; attempt++) {
+      int next_depth;
+      graphNode next = lastLevelMinDegree(graph, root, stamp++, seen, queue, next_depth);
+      if (attempt > 0 && next_depth <= depth) break;
+      depth = next_depth;
+      root = next;
+    }
+
+    // Cuthill-McKee BFS, each vertex's new neighbors by ascending degree
+    size_t head = order.size();
+    order.push_back(root);
+    placed[root] = 1;
+    while (head < order.size()) {
+      const graphNode v = order[head++];
+      const size_t first = order.size();
+      for (graphNode u : graph.neighbors(v)) {
+        if (!placed[u]) {
+          placed[u] = 1;
+          order.push_back(u);
+        }
+      }
+      std::sort(order.begin() + first, order.end(), byDegree);
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+std::vector<graphNode> gorder(const CSRGraph &graph) {
+  const int n = graph.numVertices();
+  std::vector<graphNode> order;
+  order.reserve(n);
+  BucketQueue heap(std::vector<int>(n, 0));
+
+  // A vertex entering the window raises the score of its neighbors and of
+  // their neighbors; leaving it takes the same amounts back
+  auto scoreWindowVertex = [&](graphNode v, bool entering) {
+    for (graphNode u : graph.neighbors(v)) {
+      if (heap.contains(u)) entering ? heap.increment(u) : heap.decrement(u);
+      if (graph.degree(u) > GORDER_HUB_DEGREE) continue;
+      for (graphNode w : graph.neighbors(u)) {
+        if (w != v && heap.contains(w)) entering ? heap.increment(w) : heap.decrement(w);
+      }
+    }
+  };
+
+  // Start from the highest-degree vertex, as Gorder does
+  graphNode v = n > 0 ? 0 : -1;
+  for (int u = 1; u < n; u++) {
+    if (graph.degree(u) > graph.degree(v)) v = u;
+  }
+  if (v >= 0) heap.remove(v);
+
+  while (v >= 0) {
+    order.push_back(v);
+    scoreWindowVertex(v, true);
+    if (order.size() > static_cast<size_t>(GORDER_WINDOW)) {
+      scoreWindowVertex(order[order.size() - 1 - GORDER_WINDOW], false);
+    }
+    v = heap.popMax();
+  }
+  return order;
+}
+
+} // namespace
+
+const char *vertexReorderingName(VertexReordering reordering) {
+  switch (reordering) {
+  case VertexReordering::Identity:
+    return "none";
+  case VertexReordering::ReverseCuthillMcKee:
+    return "rcm";
+  case VertexReordering::DegreeSort:
+    return "degree";
+  case VertexReordering::Gorder:
+    break;
+  }
+  return "gorder";
+}
+
+bool parseVertexReordering(const std::string &name, VertexReordering &reordering) {
+  for (VertexReordering candidate :
+       {VertexReordering::Identity, VertexReordering::ReverseCuthillMcKee,
+        VertexReordering::DegreeSort, VertexReordering::Gorder}) {
+    if (name == vertexReorderingName(candidate)) {
+      reordering = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<graphNode> computeVertexReordering(const CSRGraph &graph,
+                                               VertexReordering reordering) {
+  // Every ordering lists old ids in their new order
+  std::vector<graphNode> order;
+  switch (reordering) {
+  case VertexReordering::Identity:
+    order.resize(graph.numVertices());
+    std::iota(order.begin(), order.end(), 0);
+    break;
+  case VertexReordering::ReverseCuthillMcKee:
+    order = reverseCuthillMcKee(graph);
+    break;
+  case VertexReordering::DegreeSort:
+    order = computeColoringOrder(graph, ColoringOrder::LargestFirst);
+    break;
+  case VertexReordering::Gorder:
+    order = gorder(graph);
+    break;
+  }
+
+  return orderToNewIds(order);
+}
+
+std::vector<graphNode> orderToNewIds(const std::vector<graphNode> &order) {
+  std::vector<graphNode> new_ids(order.size());
+  for (size_t i = 0; i < order.size(); i++) new_ids[order[i]] = static_cast<graphNode>(i);
+  return new_ids;
+}
+
+ReorderedGraph::ReorderedGraph(const CSRGraph &original, VertexReordering reordering)
+    : ReorderedGraph(original, computeVertexReordering(original, reordering)) {}
+
+ReorderedGraph::ReorderedGraph(const CSRGraph &original, std::vector<graphNode> new_ids)
+    : new_ids(std::move(new_ids)), graph(original.relabeled(this->new_ids)) {}
+
+void ReorderedGraph::restoreOriginalIds(const std::vector<color> &relabeled_colors,
+                                        std::vector<color> &colors) const {
+  const int n = static_cast<int>(new_ids.size());
+  colors.resize(n);
+  #pragma omp parallel for schedule(static)
+  for (int v = 0; v < n; v++) {
+    colors[v] = relabeled_colors[new_ids[v]];
+  }
+}
+
+void ReorderedColorGraph::colorGraph(const CSRGraph &, std::vector<color> &colors) {
+  std::vector<color> relabeled_colors;
+  engine->colorGraph(reordered->graph, relabeled_colors);
+
+  PhaseTimer::Scope phase(Phase::Output);
+  reordered->restoreOriginalIds(relabeled_colors, colors);
+}
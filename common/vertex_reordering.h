@@ -0,0 +1,95 @@
+/**
+ * @file vertex_reordering.h
+ * @brief Locality-improving vertex relabelings applied before coloring
+ *
+ * Input vertex ids are arbitrary, so the color loads an engine makes for a
+ * vertex's neighbors land all over the colors array. A reordering renames
+ * the vertices so that neighbors get nearby ids:
+ *  - rcm:    reverse Cuthill-McKee, a BFS from a pseudo-peripheral vertex
+ *            of every component that visits neighbors by ascending degree,
+ *            reversed. Keeps the bandwidth of the adjacency matrix small.
+ *  - degree: descending degree, buckets kept in id order, so the hubs that
+ *            most rows touch share a few cache lines.
+ *  - gorder: a Gorder-style greedy: the next id goes to the vertex with the
+ *            most neighbors and common neighbors among the last
+ *            GORDER_WINDOW placed vertices. Common neighbors are not counted
+ *            through hubs of degree above GORDER_HUB_DEGREE.
+ *
+ * The orderings are computed sequentially; relabeling the graph runs in
+ * parallel. ReorderedColorGraph runs any engine on the relabeled graph and
+ * hands back colors indexed by the original ids.
+ */
+
+#ifndef VERTEX_REORDERING_H
+#define VERTEX_REORDERING_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "color_graph.h"
+#include "csr_graph.h"
+
+enum class VertexReordering { Identity, ReverseCuthillMcKee, DegreeSort, Gorder };
+
+constexpr int GORDER_WINDOW = 5;
+constexpr int GORDER_HUB_DEGREE = 256;
+
+const char *vertexReorderingName(VertexReordering reordering);
+
+/**
+ * @brief Parses none, rcm, degree or gorder
+ *
+ * @return False for any other name
+ */
+bool parseVertexReordering(const std::string &name, VertexReordering &reordering);
+
+/**
+ * @brief New id of every vertex: new_ids[old id]
+ */
+std::vector<graphNode> computeVertexReordering(const CSRGraph &graph, VertexReordering reordering);
+
+/**
+ * @brief Inverts a list of vertices into new ids, so order[i] becomes vertex i
+ */
+std::vector<graphNode> orderToNewIds(const std::vector<graphNode> &order);
+
+/**
+ * @brief A relabeled graph together with the renaming that produced it
+ */
+struct ReorderedGraph {
+  ReorderedGraph(const CSRGraph &original, VertexReordering reordering);
+  // new_ids[v] is the new id of original vertex v
+  ReorderedGraph(const CSRGraph &original, std::vector<graphNode> new_ids);
+
+  std::vector<graphNode> new_ids;  // Indexed by original id
+  CSRGraph graph;
+
+  /**
+   * @brief Reindexes colors of the relabeled graph by original id
+   */
+  void restoreOriginalIds(const std::vector<color> &relabeled_colors,
+                          std::vector<color> &colors) const;
+};
+
+/**
+ * @brief Colors the shared relabeled graph instead of the graph it is handed
+ *
+ * The graph passed to colorGraph() must be the original the ReorderedGraph
+ * was built from; it only fixes the size of the result.
+ */
+class ReorderedColorGraph : public ColorGraph {
+public:
+  ReorderedColorGraph(std::unique_ptr<ColorGraph> engine,
+                      std::shared_ptr<const ReorderedGraph> reordered)
+      : engine(std::move(engine)), reordered(std::move(reordered)) {}
+
+  void colorGraph(const CSRGraph &graph, std::vector<color> &colors) override;
+  using ColorGraph::colorGraph;
+
+private:
+  std::unique_ptr<ColorGraph> engine;
+  std::shared_ptr<const ReorderedGraph> reordered;
+};
+
+#endif // VERTEX_REORDERING_H
@@ -0,0 +1,147 @@
+/**
+ * @file work_stealing_deque.h
+ * @brief Lock-free Chase–Lev work-stealing deque
+ *
+ * The owning thread pushes and pops at the bottom without locks; any other
+ * thread may steal from the top with a single CAS. Memory orderings follow
+ * Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for
+ * Weak Memory Models" (PPoPP 2013). The ring buffer grows on demand; outgrown
+ * buffers stay allocated until the deque is destroyed because a thief may
+ * still be reading from them.
+ *
+ * T must be trivially copyable and small enough for std::atomic<T> to be
+ * lock-free, e.g. a pair of 32-bit indices.
+ */
+
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "csr_graph.h"
+
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable<T>::value, "deque items must be trivially copyable");
+
+public:
+  enum class StealResult { Success, Empty, Lost };
+
+  explicit WorkStealingDeque(int64_t capacity = 64) : top(0), bottom(0) {
+    int64_t size = 1;
+    while (size < capacity) size <<= 1;
+    buffers.emplace_back(new Buffer(size));
+    buffer.store(buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+  /**
+   * @brief Owner only: adds an item at the bottom
+   */
+  void push(const T &item) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Buffer *current = buffer.load(std::memory_order_relaxed);
+    if (b - t > current->mask) {
+      current = grow(current, t, b);
+    }
+    current->put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Owner only: takes the most recently pushed item
+   * @return False if the deque was empty or a thief won the last item
+   */
+  bool pop(T &item) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer *current = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    item = current->get(b);
+    if (t == b) {
+      // Last item: race the thieves for it through top
+      bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Any thread: takes the oldest item
+   * @return Lost if another thread took the item first; the deque may still hold work
+   */
+  StealResult steal(T &item) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return StealResult::Empty;
+    }
+
+    Buffer *current = buffer.load(std::memory_order_acquire);
+    T candidate = current->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      return StealResult::Lost;
+    }
+    item = candidate;
+    return StealResult::Success;
+  }
+
+  /**
+   * @brief Approximate number of queued items; exact only when no thread is operating
+   */
+  int64_t size() const {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_relaxed);
+    return b > t ? b - t : 0;
+  }
+
+private:
+  struct Buffer {
+    explicit Buffer(int64_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+    T get(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+    void put(int64_t index, const T &item) {
+      slots[index & mask].store(item, std::memory_order_relaxed);
+    }
+
+    int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  Buffer *grow(Buffer *current, int64_t t, int64_t b) {
+    Buffer *larger = new Buffer((current->mask + 1) * 2);
+    for (int64_t i = t; i < b; i++) {
+      larger->put(i, current->get(i));
+    }
+    buffers.emplace_back(larger);
+    buffer.store(larger, std::memory_order_release);
+    return larger;
+  }
+
+  // Owner and thieves hammer different ends, so keep them on separate lines
+  alignas(CACHE_LINE_SIZE) std::atomic<int64_t> top;
+  alignas(CACHE_LINE_SIZE) std::atomic<int64_t> bottom;
+  alignas(CACHE_LINE_SIZE) std::atomic<Buffer *> buffer;
+  std::vector<std::unique_ptr<Buffer>> buffers;  // Owner only; keeps outgrown buffers alive
+};
+
+#endif // WORK_STEALING_DEQUE_H
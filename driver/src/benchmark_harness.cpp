@@ -0,0 +1,371 @@
+#include "benchmark_harness.h"
+
+#include "coloring_validator.h"
+#include "../../traditional/src/timing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <omp.h>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+std::vector<double> sortedTimes(const BenchmarkResult &result) {
+  std::vector<double> sorted = result.times;
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
+
+// Quoted JSON string, with quotes, backslashes and control characters escaped
+std::string jsonString(const std::string &text) {
+  std::string quoted = "\"";
+  for (char ch : text) {
+    switch (ch) {
+    case '"':
+      quoted += "\\\"";
+      break;
+    case '\\':
+      quoted += "\\\\";
+      break;
+    case '\n':
+      quoted += "\\n";
+      break;
+    case '\t':
+      quoted += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(ch) < 0x20) {
+        char escaped[8];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(ch));
+        quoted += escaped;
+      } else {
+        quoted += ch;
+      }
+    }
+  }
+  return quoted + "\"";
+}
+
+// Left-aligned name padded to width; names never get cut
+void writeEngineCell(std::ostream &out, const std::string &name, size_t width) {
+  out << name << std::string(width > name.size() ? width - name.size() : 0, ' ');
+}
+
+// Points stdout at /dev/null for its lifetime, so printf output is dropped too
+class SilencedStdout {
+public:
+  SilencedStdout() {
+    std::cout.flush();
+    fflush(stdout);
+    saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved >= 0 && null_fd >= 0) dup2(null_fd, STDOUT_FILENO);
+    if (null_fd >= 0) close(null_fd);
+  }
+  ~SilencedStdout() {
+    std::cout.flush();
+    fflush(stdout);
+    if (saved >= 0) {
+      dup2(saved, STDOUT_FILENO);
+      close(saved);
+    }
+  }
+
+private:
+  int saved;
+};
+
+} // namespace
+
+double BenchmarkResult::minTime() const {
+  return times.empty() ? 0 : *std::min_element(times.begin(), times.end());
+}
+
+double BenchmarkResult::medianTime() const {
+  if (times.empty()) return 0;
+  std::vector<double> sorted = sortedTimes(*this);
+  size_t mid = sorted.size() / 2;
+  return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+double BenchmarkResult::p95Time() const {
+  if (times.empty()) return 0;
+  std::vector<double> sorted = sortedTimes(*this);
+  size_t rank = static_cast<size_t>(std::ceil(0.95 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+double BenchmarkResult::meanTime() const {
+  double sum = 0;
+  for (double t : times) sum += t;
+  return times.empty() ? 0 : sum / times.size();
+}
+
+double BenchmarkResult::stddevTime() const {
+  if (times.size() < 2) return 0;
+  double mean = meanTime();
+  double squares = 0;
+  for (double t : times) squares += (t - mean) * (t - mean);
+  return std::sqrt(squares / (times.size() - 1));
+}
+
+double BenchmarkResult::ipc() const {
+  const uint64_t cycles = counts[PerfEvent::Cycles];
+  return cycles > 0 ? static_cast<double>(counts[PerfEvent::Instructions]) / cycles : 0;
+}
+
+double BenchmarkResult::missesPerEdge(PerfEvent event) const {
+  return edges > 0 ? meanCount(event) / edges : 0;
+}
+
+double BenchmarkResult::meanCount(PerfEvent event) const {
+  return times.empty() ? 0 : static_cast<double>(counts[event]) / times.size();
+}
+
+BenchmarkResult BenchmarkHarness::run(const EngineInfo &engine, int threads,
+                                      const CSRGraph &graph, bool quiet,
+                                      bool print_histogram) {
+  BenchmarkResult result;
+  result.engine = engine.name;
+  result.threads = threads;
+  result.edges = graph.numAdjacencies() / 2;
+  result.counted = PerfCounters::enabled();
+
+  Timer t;
+  for (int i = 0; i < warmup + repetitions; i++) {
+    const bool measured = i >= warmup;
+    std::cout << "--- " << engine.name << " (" << threads << " threads) "
+              << (measured ? "run " : "warmup ") << (measured ? i - warmup + 1 : i + 1) << "/"
+              << (measured ? repetitions : warmup) << std::endl;
+
+    omp_set_num_threads(threads);
+    // New pool threads get their counters before the run, not in its first phase
+    PerfCounters::attachOpenMPThreads();
+
+    // Some engines change std::cout's precision or width; the harness's lines keep its own
+    std::ios format(nullptr);
+    format.copyfmt(std::cout);
+    std::vector<color> colors;
+    double time_spent;
+    PerfCounts counts;
+    {
+      std::unique_ptr<SilencedStdout> silenced;
+      if (quiet) silenced.reset(new SilencedStdout());
+      // Built untimed, but silenced too: some constructors print their settings
+      std::unique_ptr<ColorGraph> cg = engine.create(threads);
+      PhaseTimer::reset();
+      std::unique_ptr<TxnTelemetry::Collector> collector;
+      if (TxnTelemetry::requestedPath()) collector.reset(new TxnTelemetry::Collector());
+      const PerfCounts start_counts = PerfCounters::readAll();
+      t.reset();
+      cg->colorGraph(graph, colors);
+      time_spent = t.elapsed();
+      counts = PerfCounters::readAll() - start_counts;
+      if (collector) {
+        for (TxnTelemetry &report : collector->reports()) {
+          result.telemetry.push_back({i + 1, !measured, report});
+        }
+      }
+    }
+    std::cout.copyfmt(format);
+
+    ColoringReport report = validateColoring(graph, colors);
+    std::cout << "Time spent: " << time_spent << std::endl;
+    PhaseTotals phases;
+    if (PhaseTimer::enabled()) {
+      phases = PhaseTimer::totals();
+      PhaseTimer::printSummary(std::cout, phases);
+      if (PerfCounters::enabled()) PhaseTimer::printCounters(std::cout, phases, result.edges);
+    }
+    if (PerfCounters::enabled()) PerfCounters::printSummary(std::cout, counts, result.edges);
+    std::cout << "Colored with " << report.numColors() << " colors\n";
+    if (!quiet || !report.valid()) printColoringReport(std::cout, report, print_histogram);
+    if (!report.valid()) std::cout << "Failed to color graph correctly\n";
+
+    result.valid = result.valid && report.valid();
+    if (!measured) continue;
+
+    if (result.times.empty() || report.numColors() < result.min_colors) {
+      result.min_colors = report.numColors();
+    }
+    result.max_colors = std::max(result.max_colors, report.numColors());
+    result.times.push_back(time_spent);
+    result.counts += counts;
+
+    if (PhaseTimer::enabled()) {
+      result.phase_seconds.resize(NUM_PHASES);
+      for (int p = 0; p < NUM_PHASES; p++) {
+        result.phase_seconds[p] += phases.wall_seconds[p] / repetitions;
+      }
+    }
+  }
+  return result;
+}
+
+void printBenchmarkTable(std::ostream &out, const std::vector<BenchmarkResult> &results) {
+  // Wide enough for the longest name, e.g. with order and post-pass suffixes
+  size_t width = strlen("engine");
+  for (const BenchmarkResult &r : results) width = std::max(width, r.engine.size());
+
+  char line[160];
+  writeEngineCell(out, "engine", width);
+  snprintf(line, sizeof(line), " %7s %5s %10s %10s %10s %10s %7s %7s %5s\n", "threads", "runs",
+           "min(s)", "median(s)", "p95(s)", "stddev(s)", "colors", "max_col", "valid");
+  out << line;
+  for (const BenchmarkResult &r : results) {
+    writeEngineCell(out, r.engine, width);
+    snprintf(line, sizeof(line), " %7d %5zu %10.5f %10.5f %10.5f %10.5f %7d %7d %5s\n",
+             r.threads, r.times.size(), r.minTime(), r.medianTime(), r.p95Time(), r.stddevTime(),
+             r.min_colors, r.max_colors, r.valid ? "yes" : "no");
+    out << line;
+  }
+
+  if (!results.empty() && results[0].counted) {
+    out << "\nHardware counters (mean per run; misses per edge)\n";
+    writeEngineCell(out, "engine", width);
+    snprintf(line, sizeof(line), " %7s %7s %10s %10s %10s\n", "threads", "ipc", "llc/edge",
+             "br/edge", "tx_aborts");
+    out << line;
+    for (const BenchmarkResult &r : results) {
+      writeEngineCell(out, r.engine, width);
+      snprintf(line, sizeof(line), " %7d %7.3f %10.5f %10.5f %10.0f\n", r.threads, r.ipc(),
+               r.missesPerEdge(PerfEvent::LLCMisses),
+               r.missesPerEdge(PerfEvent::BranchMisses), r.meanCount(PerfEvent::TxAborts));
+      out << line;
+    }
+  }
+
+  if (results.empty() || results[0].phase_seconds.empty()) return;
+  out << "\nMean seconds per phase (slowest thread)\n";
+  writeEngineCell(out, "engine", width);
+  snprintf(line, sizeof(line), " %7s", "threads");
+  out << line;
+  // Column-width labels in Phase order
+  static const char *const labels[NUM_PHASES] = {"setup",   "ordering", "partition",
+                                                 "precolor", "color",   "detect",
+                                                 "resolve", "recolor", "output"};
+  for (int p = 0; p < NUM_PHASES; p++) {
+    snprintf(line, sizeof(line), " %10s", labels[p]);
+    out << line;
+  }
+  out << "\n";
+  for (const BenchmarkResult &r : results) {
+    writeEngineCell(out, r.engine, width);
+    snprintf(line, sizeof(line), " %7d", r.threads);
+    out << line;
+    for (double seconds : r.phase_seconds) {
+      snprintf(line, sizeof(line), " %10.5f", seconds);
+      out << line;
+    }
+    out << "\n";
+  }
+}
+
+void writeBenchmarkCSV(std::ostream &out, const std::vector<BenchmarkResult> &results) {
+  // Phase columns, one per phase, only when the phases were timed
+  const bool phases = !results.empty() && !results[0].phase_seconds.empty();
+  out << "engine,threads,runs,min_s,median_s,p95_s,mean_s,stddev_s,min_colors,max_colors,valid";
+  for (int p = 0; phases && p < NUM_PHASES; p++) {
+    std::string name = phaseName(static_cast<Phase>(p));
+    std::replace(name.begin(), name.end(), ' ', '_');
+    out << "," << name << "_s";
+  }
+  const bool counted = !results.empty() && results[0].counted;
+  if (counted) out << ",ipc,llc_misses_per_edge,branch_misses_per_edge,tx_aborts";
+  out << "\n";
+
+  char line[256];
+  for (const BenchmarkResult &r : results) {
+    snprintf(line, sizeof(line), "%s,%d,%zu,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d,%s",
+             r.engine.c_str(), r.threads, r.times.size(), r.minTime(), r.medianTime(),
+             r.p95Time(), r.meanTime(), r.stddevTime(), r.min_colors, r.max_colors,
+             r.valid ? "true" : "false");
+    out << line;
+    for (double seconds : r.phase_seconds) {
+      snprintf(line, sizeof(line), ",%.6f", seconds);
+      out << line;
+    }
+    if (counted) {
+      snprintf(line, sizeof(line), ",%.4f,%.6f,%.6f,%.0f", r.ipc(),
+               r.missesPerEdge(PerfEvent::LLCMisses), r.missesPerEdge(PerfEvent::BranchMisses),
+               r.meanCount(PerfEvent::TxAborts));
+      out << line;
+    }
+    out << "\n";
+  }
+}
+
+void writeBenchmarkJSON(std::ostream &out, const std::vector<BenchmarkResult> &results,
+                        const CSRGraph &graph, int warmup) {
+  std::ios format(nullptr);
+  format.copyfmt(out);
+  out.unsetf(std::ios::floatfield);
+  out.precision(9);
+
+  out << "{\n  \"vertices\": " << graph.numVertices()
+      << ",\n  \"edges\": " << graph.numAdjacencies() / 2 << ",\n  \"warmup\": " << warmup
+      << ",\n  \"results\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchmarkResult &r = results[i];
+    out << (i ? ",\n" : "\n") << "    {\"engine\": " << jsonString(r.engine) << ", \"threads\": "
+        << r.threads << ", \"min_s\": " << r.minTime() << ", \"median_s\": " << r.medianTime()
+        << ", \"p95_s\": " << r.p95Time() << ", \"mean_s\": " << r.meanTime()
+        << ", \"stddev_s\": " << r.stddevTime() << ", \"min_colors\": " << r.min_colors
+        << ", \"max_colors\": " << r.max_colors
+        << ", \"valid\": " << (r.valid ? "true" : "false") << ", \"times_s\": [";
+    for (size_t t = 0; t < r.times.size(); t++) out << (t ? ", " : "") << r.times[t];
+    out << "]";
+    if (!r.phase_seconds.empty()) {
+      out << ", \"phases_s\": {";
+      for (int p = 0; p < NUM_PHASES; p++) {
+        out << (p ? ", " : "") << jsonString(phaseName(static_cast<Phase>(p))) << ": "
+            << r.phase_seconds[p];
+      }
+      out << "}";
+    }
+    if (r.counted) {
+      out << ", \"counters\": {\"ipc\": " << r.ipc()
+          << ", \"llc_misses_per_edge\": " << r.missesPerEdge(PerfEvent::LLCMisses)
+          << ", \"branch_misses_per_edge\": " << r.missesPerEdge(PerfEvent::BranchMisses);
+      for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+        const PerfEvent event = static_cast<PerfEvent>(e);
+        if (PerfCounters::available(event)) {
+          out << ", " << jsonString(perfEventName(event)) << ": " << r.meanCount(event);
+        }
+      }
+      out << "}";
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+  out.copyfmt(format);
+}
+
+void writeTelemetryJSON(std::ostream &out, const std::vector<BenchmarkResult> &results) {
+  out << "[";
+  bool first = true;
+  for (const BenchmarkResult &r : results) {
+    for (const RunTelemetry &run : r.telemetry) {
+      // The engine's own report, indented one level to sit inside the entry
+      std::ostringstream report;
+      run.report.writeJSON(report);
+      std::string nested = report.str();
+      while (!nested.empty() && nested.back() == '\n') nested.pop_back();
+      for (size_t at = nested.find('\n'); at != std::string::npos; at = nested.find('\n', at + 5)) {
+        nested.replace(at, 1, "\n    ");
+      }
+
+      out << (first ? "\n" : ",\n") << "  {\"engine\": " << jsonString(r.engine)
+          << ", \"threads\": " << r.threads << ", \"run\": " << run.run
+          << ", \"warmup\": " << (run.warmup ? "true" : "false") << ",\n    \"report\": "
+          << nested << "}";
+      first = false;
+    }
+  }
+  out << "\n]\n";
+}
@@ -0,0 +1,103 @@
+/**
+ * @file benchmark_harness.h
+ * @brief Repeated timing of registry engines on an already loaded graph
+ *
+ * Every measured run builds a fresh engine, colors the graph and validates
+ * the result; warmup runs do the same but are not recorded. The summary is
+ * computed from the recorded times, so one noisy run on a shared machine
+ * shows up in p95 and stddev instead of deciding the result. With
+ * PerfCounters enabled each run is also counted across all of its threads.
+ */
+
+#ifndef BENCHMARK_HARNESS_H
+#define BENCHMARK_HARNESS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "csr_graph.h"
+#include "engine_registry.h"
+#include "perf_counters.h"
+#include "phase_timer.h"
+#include "txn_telemetry.h"
+
+// Transaction report of one run, warmup runs included
+struct RunTelemetry {
+  int run;  // 1-based, in run order
+  bool warmup;
+  TxnTelemetry report;
+};
+
+struct BenchmarkResult {
+  std::string engine;
+  int threads = 0;
+  std::vector<double> times;  // Seconds per measured run, in run order
+  int min_colors = 0;
+  int max_colors = 0;
+  bool valid = true;  // Every measured and warmup run produced a proper coloring
+  // Mean over measured runs of each phase's slowest-thread time; empty unless phases were timed
+  std::vector<double> phase_seconds;
+  bool counted = false;  // Hardware counters were read around every measured run
+  PerfCounts counts;     // Summed over measured runs
+  uint64_t edges = 0;
+  std::vector<RunTelemetry> telemetry;  // Only collected when TXN_TELEMETRY is set
+
+  double ipc() const;
+  double missesPerEdge(PerfEvent event) const;  // Mean per run, over the graph's edges
+  double meanCount(PerfEvent event) const;
+
+  double minTime() const;
+  double medianTime() const;
+  double p95Time() const;  // Nearest-rank 95th percentile
+  double meanTime() const;
+  double stddevTime() const;  // Sample standard deviation; 0 for a single run
+};
+
+class BenchmarkHarness {
+public:
+  BenchmarkHarness(int warmup, int repetitions) : warmup(warmup), repetitions(repetitions) {}
+
+  /**
+   * @brief Sets the OpenMP thread count, then runs warmup + repetitions fresh engines
+   *
+   * With PhaseTimer enabled every run also prints its phase breakdown, and
+   * with PerfCounters enabled its counters. With TXN_TELEMETRY set, the
+   * transaction reports of the engine's runs are kept in the result rather
+   * than written by the engine, so later runs cannot overwrite them.
+   *
+   * @param quiet Discards what the engine writes to stdout during its runs
+   */
+  BenchmarkResult run(const EngineInfo &engine, int threads, const CSRGraph &graph,
+                      bool quiet, bool print_histogram);
+
+  int warmupRuns() const { return warmup; }
+  int measuredRuns() const { return repetitions; }
+
+private:
+  int warmup;
+  int repetitions;
+};
+
+/**
+ * @brief One row per result: engine, threads, runs, timing summary, colors, validity
+ *
+ * Results with phase times get a second table of mean seconds per phase, and
+ * counted results a table of IPC and misses per edge.
+ */
+void printBenchmarkTable(std::ostream &out, const std::vector<BenchmarkResult> &results);
+
+void writeBenchmarkCSV(std::ostream &out, const std::vector<BenchmarkResult> &results);
+
+/**
+ * @brief Summary plus every measured time, under the graph's size and the run counts
+ */
+void writeBenchmarkJSON(std::ostream &out, const std::vector<BenchmarkResult> &results,
+                        const CSRGraph &graph, int warmup);
+
+/**
+ * @brief Every collected transaction report, as an array keyed by engine, threads and run
+ */
+void writeTelemetryJSON(std::ostream &out, const std::vector<BenchmarkResult> &results);
+
+#endif // BENCHMARK_HARNESS_H
@@ -0,0 +1,64 @@
+#include "engine_registry.h"
+
+#include "../../traditional/src/graph.h"
+#include "../../transactional/src/graph.h"
+#include "../../transactional/htm_coloring.h"
+
+const EngineInfo *EngineRegistry::find(const std::string &name) const {
+  for (const EngineInfo &engine : engines_) {
+    if (engine.name == name) return &engine;
+  }
+  return nullptr;
+}
+
+namespace {
+
+// Engines that take the thread count from OpenMP, which the driver sets per run
+EngineInfo openmpEngine(const char *name, const char *description,
+                        std::unique_ptr<ColorGraph> (*factory)()) {
+  return {name, description, true, [factory](int) { return factory(); }};
+}
+
+EngineInfo stmEngine(const char *name, const char *backend) {
+  std::string description = std::string("Transactional greedy on the ") + backend + " STM";
+  return {name, description, true, [backend](int num_threads) {
+            return createSTMColorGraph(backend, 2, false, num_threads);
+          }};
+}
+
+EngineRegistry makeBuiltinRegistry() {
+  EngineRegistry registry;
+  registry.add({"seq", "Sequential greedy baseline", false,
+                [](int) { return createSeqColorGraph(); }});
+  // Saturation picks the next vertex, not the ids
+  registry.add({"dsatur", "Sequential DSatur, highest saturation first", false,
+                [](int) { return createDSaturColorGraph(); }, false});
+  registry.add(openmpEngine("trad_1", "Parallel greedy with conflict resolution", createBasicParallelColorGraph));
+  // Random priorities decide the order
+  EngineInfo jones_plassmann = openmpEngine("trad_2", "Jones-Plassmann with dependency counters",
+                                            createSpeculativeGraphColoring);
+  jones_plassmann.follows_order = false;
+  registry.add(jones_plassmann);
+  registry.add(openmpEngine("trad_3", "Work-stealing partitioned coloring",
+                            createWorkStealingColorGraph));
+  registry.add(openmpEngine("trad_4", "Degree-ordered parallel coloring",
+                            createHighPerformanceColorGraph));
+  registry.add(openmpEngine("trad_5", "Iterative speculative coloring with worklists",
+                            createIterativeColorGraph));
+  registry.add(openmpEngine("txn", "Mimicked transactional coloring",
+                            createTransactionalColorGraph));
+  registry.add(openmpEngine("cas", "Lock-free compare-and-swap baseline", createCASColorGraph));
+  registry.add(stmEngine("stm-tl2", "tl2"));
+  registry.add(stmEngine("stm-norec", "norec"));
+  registry.add(stmEngine("stm-libitm", "libitm"));
+  registry.add({"htm", "Intel TSX coloring with a fallback lock", true,
+                [](int num_threads) { return createHTMColorGraph(num_threads); }});
+  return registry;
+}
+
+} // namespace
+
+const EngineRegistry &EngineRegistry::builtin() {
+  static const EngineRegistry registry = makeBuiltinRegistry();
+  return registry;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file engine_registry.h
+ * @brief Name-to-factory table of the coloring engines linked into the driver
+ *
+ * Every engine of the traditional and transactional builds registers here
+ * under the name its old driver flag used (seq, trad_1, txn, ...), so one
+ * process can load a graph once and run any list of engines over it.
+ */
+
+#ifndef ENGINE_REGISTRY_H
+#define ENGINE_REGISTRY_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "color_graph.h"
+
+struct EngineInfo {
+  std::string name;
+  std::string description;
+  // False for engines that ignore the thread count; they run once per list
+  bool parallel;
+  // Builds a fresh engine for one run with num_threads threads
+  std::function<std::unique_ptr<ColorGraph>(int num_threads)> create;
+  // False for engines whose visiting order does not depend on vertex ids,
+  // so a preset coloring order (-order) would leave their runs unchanged
+  bool follows_order = true;
+};
+
+class EngineRegistry {
+public:
+  void add(EngineInfo engine) { engines_.push_back(std::move(engine)); }
+
+  /**
+   * @brief Engine registered under name, or nullptr
+   */
+  const EngineInfo *find(const std::string &name) const;
+
+  const std::vector<EngineInfo> &engines() const { return engines_; }
+
+  /**
+   * @brief Registry holding every engine built into this binary
+   */
+  static const EngineRegistry &builtin();
+
+private:
+  std::vector<EngineInfo> engines_;
+};
+
+#endif // ENGINE_REGISTRY_H
@@ -0,0 +1,306 @@
+#include "benchmark_harness.h"
+#include "color_balancing.h"
+#include "coloring_order.h"
+#include "engine_registry.h"
+#include "graph_loader.h"
+#include "iterated_greedy.h"
+#include "vertex_reordering.h"
+#include "../../traditional/src/timing.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+struct StartupOptions {
+  std::string inputFile = "";
+  CSRBuildOptions buildOptions;
+  bool printHistogram = false;
+  bool listEngines = false;
+  std::vector<std::string> engines = {"seq"};
+  std::vector<int> threadCounts;
+  std::vector<std::string> reorderings;
+  std::vector<std::string> orders;
+  double recolorSeconds = -1;  // Iterated greedy budget per run; negative disables it
+  bool balanceClasses = false;
+  int warmup = 0;
+  int repetitions = 1;
+  bool quiet = false;
+  bool printPhases = false;
+  bool countEvents = false;
+  std::string csvFile = "";
+  std::string jsonFile = "";
+};
+
+// Splits a comma-separated list, dropping empty items
+std::vector<std::string> splitList(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) items.push_back(item);
+  }
+  return items;
+}
+
+StartupOptions parseOptions(int argc, const char **argv) {
+  StartupOptions so;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      so.inputFile = argv[++i];
+    } else if (strcmp(argv[i], "-hist") == 0) {
+      so.printHistogram = true;
+    } else if (strcmp(argv[i], "-dedup") == 0) {
+      so.buildOptions.remove_duplicates = true;
+      so.buildOptions.remove_self_loops = true;
+    } else if (strcmp(argv[i], "-list") == 0) {
+      so.listEngines = true;
+    } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+      so.engines = splitList(argv[++i]);
+    } else if (strcmp(argv[i], "-reorder") == 0 && i + 1 < argc) {
+      so.reorderings = splitList(argv[++i]);
+    } else if (strcmp(argv[i], "-order") == 0 && i + 1 < argc) {
+      so.orders = splitList(argv[++i]);
+    } else if (strcmp(argv[i], "-recolor") == 0 && i + 1 < argc) {
+      so.recolorSeconds = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-balance") == 0) {
+      so.balanceClasses = true;
+    } else if (strcmp(argv[i], "-warmup") == 0 && i + 1 < argc) {
+      so.warmup = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-reps") == 0 && i + 1 < argc) {
+      so.repetitions = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-phases") == 0) {
+      so.printPhases = true;
+    } else if (strcmp(argv[i], "-counters") == 0) {
+      so.countEvents = true;
+    } else if (strcmp(argv[i], "-q") == 0) {
+      so.quiet = true;
+    } else if (strcmp(argv[i], "-csv") == 0 && i + 1 < argc) {
+      so.csvFile = argv[++i];
+    } else if (strcmp(argv[i], "-json") == 0 && i + 1 < argc) {
+      so.jsonFile = argv[++i];
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      so.threadCounts.clear();
+      for (const std::string &count : splitList(argv[++i])) {
+        so.threadCounts.push_back(atoi(count.c_str()));
+      }
+    }
+  }
+  if (so.threadCounts.empty()) so.threadCounts.push_back(omp_get_max_threads());
+  return so;
+}
+
+// A relabeling applied before the runs: a locality reordering or a coloring order
+struct GraphLayout {
+  std::string name = "none";
+  VertexReordering reordering = VertexReordering::Identity;
+  bool preset_order = false;
+  ColoringOrder order = ColoringOrder::LargestFirst;
+};
+
+void createCompleteTest(std::vector<graphNode> &nodes,
+                        std::vector<std::pair<graphNode, graphNode>> &pairs) {
+  int numNodes = 5000;
+  nodes.resize(numNodes);
+  for (int i = 0; i < numNodes; i++) {
+    nodes[i] = i;
+  }
+  pairs.clear();
+  for (int i = 0; i < numNodes; i++) {
+    for (int j = i + 1; j < numNodes; j++) {
+      pairs.push_back(std::make_pair(i, j));
+    }
+  }
+}
+
+// Writes a report to path, or to stdout for "-"
+template <typename Writer>
+bool writeReport(const std::string &path, const char *what, Writer write) {
+  if (path == "-") {
+    write(std::cout);
+    return true;
+  }
+  std::ofstream file(path);
+  if (!file) {
+    std::cerr << "Could not write " << path << std::endl;
+    return false;
+  }
+  write(file);
+  std::cout << what << " written to " << path << std::endl;
+  return true;
+}
+
+int main(int argc, const char **argv) {
+  StartupOptions options = parseOptions(argc, argv);
+  const EngineRegistry &registry = EngineRegistry::builtin();
+
+  if (options.listEngines) {
+    for (const EngineInfo &engine : registry.engines()) {
+      printf("%-12s %s\n", engine.name.c_str(), engine.description.c_str());
+    }
+    return 0;
+  }
+
+  // "all" runs every engine in registry order
+  std::vector<const EngineInfo *> engines;
+  for (const std::string &name : options.engines) {
+    if (name == "all") {
+      for (const EngineInfo &engine : registry.engines()) engines.push_back(&engine);
+      continue;
+    }
+    const EngineInfo *engine = registry.find(name);
+    if (!engine) {
+      std::cerr << "Unknown engine: " << name << " (-list shows the available engines)\n";
+      return 1;
+    }
+    engines.push_back(engine);
+  }
+  // One layout per -reorder and -order entry; the loaded graph alone by default
+  std::vector<GraphLayout> layouts;
+  for (const std::string &name : options.reorderings) {
+    GraphLayout layout;
+    layout.name = name;
+    if (!parseVertexReordering(name, layout.reordering)) {
+      std::cerr << "Unknown reordering: " << name << " (none, rcm, degree or gorder)\n";
+      return 1;
+    }
+    layouts.push_back(layout);
+  }
+  for (const std::string &name : options.orders) {
+    GraphLayout layout;
+    layout.name = name;
+    layout.preset_order = true;
+    if (!parseColoringOrder(name, layout.order)) {
+      std::cerr << "Unknown order: " << name << " (largest, sl, id or psl)\n";
+      return 1;
+    }
+    layouts.push_back(layout);
+  }
+  if (layouts.empty()) layouts.push_back(GraphLayout());
+  for (int threads : options.threadCounts) {
+    if (threads <= 0) {
+      std::cerr << "Thread counts must be positive\n";
+      return 1;
+    }
+  }
+  if (options.warmup < 0 || options.repetitions <= 0) {
+    std::cerr << "-warmup must be >= 0 and -reps > 0\n";
+    return 1;
+  }
+
+  std::cout.setf(std::ios::fixed, std::ios::floatfield);
+  std::cout.precision(5);
+
+  // The graph is loaded once and shared read-only by every run
+  Timer t;
+  CSRGraph graph;
+  if (!loadGraph(options.inputFile, graph, options.buildOptions)) {
+    std::vector<graphNode> nodes;
+    std::vector<std::pair<graphNode, graphNode>> pairs;
+    createCompleteTest(nodes, pairs);
+    graph = CSRGraph::fromEdges(static_cast<int>(nodes.size()), pairs, options.buildOptions);
+  }
+  std::cout << "Loaded " << graph.numVertices() << " vertices and " << graph.numAdjacencies() / 2
+            << " edges in " << t.elapsed() << " s" << std::endl;
+
+  PhaseTimer::setEnabled(options.printPhases);
+  // Runs go ahead without counters where the kernel or VM exposes no PMU
+  if (options.countEvents && !PerfCounters::enable()) {
+    std::cout << "Hardware counters unavailable: " << PerfCounters::unavailableReason() << std::endl;
+  }
+  BenchmarkHarness harness(options.warmup, options.repetitions);
+  std::vector<BenchmarkResult> results;
+  for (const GraphLayout &layout : layouts) {
+    // Each layout is computed once; its runs color the relabeled copy and
+    // report colors by original id, so they validate against the loaded graph
+    std::shared_ptr<const ReorderedGraph> reordered;
+    if (layout.preset_order) {
+      t.reset();
+      reordered = std::make_shared<const ReorderedGraph>(
+          graph, orderToNewIds(computeColoringOrder(graph, layout.order)));
+      std::cout << "Ordered by " << layout.name << " in " << t.elapsed() << " s" << std::endl;
+    } else if (layout.reordering != VertexReordering::Identity) {
+      t.reset();
+      reordered = std::make_shared<const ReorderedGraph>(graph, layout.reordering);
+      std::cout << "Reordered with " << layout.name << " in " << t.elapsed() << " s" << std::endl;
+    }
+    // Engines that sort by degree keep the preset order instead
+    PresetColoringOrder::setActive(layout.preset_order);
+
+    for (const EngineInfo *original : engines) {
+      // Their runs would repeat the unordered ones under a new name
+      if (layout.preset_order && !original->follows_order) {
+        std::cout << "Skipping " << original->name << "+" << layout.name << ": "
+                  << original->name << " does not follow a preset order" << std::endl;
+        continue;
+      }
+      EngineInfo engine = *original;
+      if (reordered) {
+        engine.name += "+" + layout.name;
+        engine.create = [original, reordered](int threads) -> std::unique_ptr<ColorGraph> {
+          return std::make_unique<ReorderedColorGraph>(original->create(threads), reordered);
+        };
+      }
+      if (options.recolorSeconds >= 0) {
+        RecolorOptions recolor;
+        recolor.time_budget_seconds = options.recolorSeconds;
+        auto create = engine.create;
+        engine.name += "+ig";
+        engine.create = [create, recolor](int threads) -> std::unique_ptr<ColorGraph> {
+          return std::make_unique<RecoloredColorGraph>(create(threads), recolor);
+        };
+      }
+      // Last, since recoloring reshapes the classes
+      if (options.balanceClasses) {
+        auto create = engine.create;
+        engine.name += "+bal";
+        engine.create = [create](int threads) -> std::unique_ptr<ColorGraph> {
+          return std::make_unique<BalancedColorGraph>(create(threads), BalanceOptions());
+        };
+      }
+
+      for (int threads : options.threadCounts) {
+        // Sequential engines run once, on one thread
+        if (!engine.parallel) threads = 1;
+
+        std::cout << "=== " << engine.name << " (" << threads << " threads) ===" << std::endl;
+        results.push_back(
+            harness.run(engine, threads, graph, options.quiet, options.printHistogram));
+        if (!engine.parallel) break;
+      }
+    }
+  }
+
+  // One row per engine and thread count, for comparing engines at a glance
+  std::cout << std::endl;
+  printBenchmarkTable(std::cout, results);
+
+  bool all_valid = true;
+  for (const BenchmarkResult &result : results) all_valid = all_valid && result.valid;
+
+  if (!options.csvFile.empty() &&
+      !writeReport(options.csvFile, "Benchmark results",
+                   [&](std::ostream &out) { writeBenchmarkCSV(out, results); })) {
+    return 1;
+  }
+  if (!options.jsonFile.empty() &&
+      !writeReport(options.jsonFile, "Benchmark results", [&](std::ostream &out) {
+        writeBenchmarkJSON(out, results, graph, options.warmup);
+      })) {
+    return 1;
+  }
+  // Engines leave their transaction reports to the harness, which keeps every run's
+  if (const char *path = TxnTelemetry::requestedPath()) {
+    if (!writeReport(path, "Transaction telemetry",
+                     [&](std::ostream &out) { writeTelemetryJSON(out, results); })) {
+      return 1;
+    }
+  }
+
+  return all_valid ? 0 : -1;
+}
@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# Test files
+FILES=("sparse-50000.txt" "random-5000.txt" "corner-50000.txt" "components-50000.txt" "complete-5000.txt")
+
+# Thread counts and engines, passed to one driver run per file
+THREADS="1,2,4,8,16,32,64"
+ENGINES="seq,trad_1,trad_2,trad_3,trad_4,trad_5,txn,cas,stm-tl2,stm-norec,stm-libitm,htm"
+
+# Unrecorded runs before, and recorded runs per engine and thread count
+WARMUP=1
+REPS=5
+
+# One CSV and one JSON file per input
+RESULTS_DIR=results
+
+# Text to binary graph converter (make convert in traditional/)
+CONVERTER=../traditional/graph_convert
+
+# Binary copy of a test file if one could be made, otherwise the text file
+graph_input() {
+    local file=$1
+    if [ -f "${file%.txt}.csr" ]; then
+        echo "${file%.txt}.csr"
+    else
+        echo "$file"
+    fi
+}
+
+# Convert inputs once so every run maps them instead of parsing text
+if [ -x "$CONVERTER" ]; then
+    for file in "${FILES[@]}"; do
+        if [ -f "$file" ] && [ ! "${file%.txt}.csr" -nt "$file" ]; then
+            "$CONVERTER" "$file" "${file%.txt}.csr" || rm -f "${file%.txt}.csr"
+        fi
+    done
+fi
+
+mkdir -p "$RESULTS_DIR"
+
+# Every coloring order and reordering must also handle a graph without vertices
+EMPTY_GRAPH=$(mktemp)
+echo 0 > "$EMPTY_GRAPH"
+./graph_coloring -f "$EMPTY_GRAPH" -e seq -order largest,sl,id,psl -q > /dev/null ||
+    echo "FAILED: coloring orders on an empty graph"
+./graph_coloring -f "$EMPTY_GRAPH" -e seq -reorder none,rcm,degree,gorder -q > /dev/null ||
+    echo "FAILED: vertex reorderings on an empty graph"
+rm -f "$EMPTY_GRAPH"
+
+for file in "${FILES[@]}"; do
+    echo "=========== $file ==========="
+    name=$(basename "${file%.txt}")
+
+    # The graph is loaded once for all engines and thread counts; the summary
+    # table (min/median/p95/stddev per engine and thread count) ends the output
+    ./graph_coloring -f $(graph_input $file) -e $ENGINES -t $THREADS \
+        -warmup $WARMUP -reps $REPS -q \
+        -csv "$RESULTS_DIR/$name.csv" -json "$RESULTS_DIR/$name.json" | sed -n '/^engine /,$p'
+done
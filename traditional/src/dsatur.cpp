@@ -0,0 +1,118 @@
+/**
+ * @file dsatur.cpp
+ * @brief Sequential DSatur coloring (Brelaz 1979)
+ *
+ * Every step colors the uncolored vertex whose neighbors already use the most
+ * distinct colors (its saturation), ties broken by larger degree and then
+ * smaller id, with the smallest color none of those neighbors use.
+ *
+ * The colors around each vertex live in a per-vertex bitset: the first 64
+ * colors in one inline word, later ones in words that grow on demand, so
+ * only vertices whose neighbors actually use that many colors pay for them.
+ * The first free color is a trailing-zero count over the inverted words, as
+ * in ForbiddenColors. Candidates sit in one max-heap per saturation
+ * level, keyed by (degree, -id). A vertex whose saturation grows is pushed
+ * into the next level and its old entry is dropped when popped, so a step
+ * costs O(degree * log V) instead of a scan over every uncolored vertex.
+ */
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+#include "graph.h"
+#include "phase_timer.h"
+
+class DSaturColorGraph : public ColorGraph {
+public:
+  void colorGraph(const CSRGraph &graph, std::vector<color> &colors) override {
+    const int numNodes = graph.numVertices();
+    colors.assign(numNodes, -1);
+    if (numNodes == 0) return;
+
+    {
+      PhaseTimer::Scope phase(Phase::Setup);
+      saturation.assign(numNodes, 0);
+      low_colors.assign(numNodes, 0);
+      high_colors.assign(numNodes, std::vector<uint64_t>());
+      levels.assign(1, Level());
+      std::vector<uint64_t> entries(numNodes);
+      for (int v = 0; v < numNodes; v++) {
+        entries[v] = entry(graph, v);
+      }
+      levels[0] = Level(std::less<uint64_t>(), std::move(entries));
+    }
+
+    PhaseTimer::Scope phase(Phase::Color);
+    int top = 0;
+    for (int colored = 0; colored < numNodes; colored++) {
+      // Highest non-empty level; stale entries are dropped on the way
+      graphNode v = -1;
+      while (v < 0) {
+        while (levels[top].empty()) top--;
+        graphNode candidate = vertexOf(levels[top].top());
+        levels[top].pop();
+        if (colors[candidate] < 0 && saturation[candidate] == top) v = candidate;
+      }
+
+      const color c = firstAvailable(v);
+      colors[v] = c;
+
+      for (graphNode u : graph.neighbors(v)) {
+        if (colors[u] >= 0 || !addNeighborColor(u, c)) continue;
+        const int level = ++saturation[u];
+        if (level >= static_cast<int>(levels.size())) levels.emplace_back();
+        levels[level].push(entry(graph, u));
+        if (level > top) top = level;
+      }
+    }
+  }
+
+private:
+  typedef std::priority_queue<uint64_t> Level;
+
+  // Larger degree first, then smaller id
+  static uint64_t entry(const CSRGraph &graph, graphNode v) {
+    return (static_cast<uint64_t>(graph.degree(v)) << 32) | (UINT32_MAX - static_cast<uint32_t>(v));
+  }
+
+  static graphNode vertexOf(uint64_t entry) {
+    return static_cast<graphNode>(UINT32_MAX - static_cast<uint32_t>(entry));
+  }
+
+  // Records c around vertex; false if a neighbor already had it
+  bool addNeighborColor(graphNode vertex, color c) {
+    uint64_t *word;
+    if (c < 64) {
+      word = &low_colors[vertex];
+    } else {
+      std::vector<uint64_t> &high = high_colors[vertex];
+      const size_t index = static_cast<size_t>(c - 64) >> 6;
+      if (index >= high.size()) high.resize(index + 1, 0);
+      word = &high[index];
+    }
+    const uint64_t bit = uint64_t(1) << (c & 63);
+    if (*word & bit) return false;
+    *word |= bit;
+    return true;
+  }
+
+  color firstAvailable(graphNode vertex) const {
+    if (~low_colors[vertex] != 0) return __builtin_ctzll(~low_colors[vertex]);
+    const std::vector<uint64_t> &high = high_colors[vertex];
+    for (size_t word = 0; word < high.size(); word++) {
+      if (~high[word] != 0) {
+        return static_cast<color>(64 + word * 64 + __builtin_ctzll(~high[word]));
+      }
+    }
+    return static_cast<color>(64 + high.size() * 64);
+  }
+
+  std::vector<int> saturation;
+  std::vector<uint64_t> low_colors;
+  std::vector<std::vector<uint64_t>> high_colors;  // Colors 64 and above, 64 per word
+  std::vector<Level> levels;
+};
+
+std::unique_ptr<ColorGraph> createDSaturColorGraph() {
+  return std::make_unique<DSaturColorGraph>();
+}
@@ -1,20 +1,24 @@
+#include "coloring_validator.h"
 #include "graph.h"
+#include "graph_loader.h"
+#include "phase_timer.h"
 #include "timing.h"
 
 #include <algorithm>
 #include <cstring>
-#include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
 
 
 // can add more Sequential Types
-enum class ColoringType { Sequential, trad_1, trad_2, trad_3, trad_4};
+enum class ColoringType { Sequential, DSatur, trad_1, trad_2, trad_3, trad_4, trad_5};
 
 struct StartupOptions {
   std::string inputFile = "";
   ColoringType coloringType = ColoringType::Sequential;
+  CSRBuildOptions buildOptions;
+  bool printHistogram = false;
+  bool printPhases = false;
 };
 
 StartupOptions parseOptions(int argc, const char **argv) {
@@ -22,8 +26,17 @@ StartupOptions parseOptions(int argc, const char **argv) {
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "-f") == 0) {
       so.inputFile = argv[i+1];
+    } else if (strcmp(argv[i], "-hist") == 0) {
+      so.printHistogram = true;
+    } else if (strcmp(argv[i], "-phases") == 0) {
+      so.printPhases = true;
+    } else if (strcmp(argv[i], "-dedup") == 0) {
+      so.buildOptions.remove_duplicates = true;
+      so.buildOptions.remove_self_loops = true;
     } else if (strcmp(argv[i], "-seq") == 0) {
       so.coloringType = ColoringType::Sequential;
+    } else if (strcmp(argv[i], "-dsatur") == 0) {
+      so.coloringType = ColoringType::DSatur;
     } else if (strcmp(argv[i], "-trad_1") == 0) {
       so.coloringType = ColoringType::trad_1;
     } else if (strcmp(argv[i], "-trad_2") == 0) {
@@ -34,67 +47,14 @@ StartupOptions parseOptions(int argc, const char **argv) {
       else if (strcmp(argv[i], "-trad_4") == 0) {
     so.coloringType = ColoringType::trad_4;
     }
+      else if (strcmp(argv[i], "-trad_5") == 0) {
+    so.coloringType = ColoringType::trad_5;
+    }
      
   }
   return so;
 }
 
-bool checkCorrectness(std::vector<graphNode> &nodes,
-                      std::unordered_map<graphNode, std::vector<graphNode>> &graph,
-                      std::unordered_map<graphNode, color> &colors) {
-  for (auto &node : nodes) {
-    if (colors.count(node) == 0)
-      return false;
-
-    color curr = colors[node];
-    if (curr == -1) std::cout << "Negative color\n";
-
-    for (auto &nbor : graph[node]) {
-      if (colors.count(nbor) == 0) {
-        return false;
-      }
-      if (colors[nbor] == curr) {
-        return false;
-      }
-    }
-  }
-  return true;
-}
-
-bool readGraphFromFile(std::string fileName, std::vector<graphNode> &nodes,
-                            std::vector<std::pair<graphNode, graphNode>> &pairs) {
-  std::ifstream inFile;
-
-  inFile.open(fileName);
-  if (!inFile) {
-    return false;
-  }
-
-  std::string line;
-
-  std::getline(inFile, line);
-  std::stringstream sstream(line);
-  std::string str;
-  std::getline(sstream, str, '\n');
-  int numVertices = (int) atoi(str.c_str());
-
-  for (int i = 0; i < numVertices; i++) {
-    nodes.push_back(i);
-  }
-
-  while(std::getline(inFile, line)) {
-    std::stringstream sstream2(line);
-    std::getline(sstream2, str, ' ');
-    int v1 = (int) atoi(str.c_str());
-    std::getline(sstream2, str, '\n');
-    int v2 = (int) atoi(str.c_str());
-
-    pairs.push_back(std::make_pair(v1, v2));
-  }
-
-  return true;
-}
-
 void createCompleteTest(std::vector<graphNode> &nodes,
                         std::vector<std::pair<graphNode, graphNode>> &pairs) {
   int numNodes = 5000;
@@ -113,11 +73,12 @@ void createCompleteTest(std::vector<graphNode> &nodes,
 int main(int argc, const char **argv) {
   StartupOptions options = parseOptions(argc, argv);
 
-  // TODO: add a read nodes + pairs from file option here
-  std::vector<graphNode> nodes;
-  std::vector<std::pair<graphNode, graphNode>> pairs;
-  if (!readGraphFromFile(options.inputFile, nodes, pairs)) {
+  CSRGraph graph;
+  if (!loadGraph(options.inputFile, graph, options.buildOptions)) {
+    std::vector<graphNode> nodes;
+    std::vector<std::pair<graphNode, graphNode>> pairs;
     createCompleteTest(nodes, pairs);
+    graph = CSRGraph::fromEdges(static_cast<int>(nodes.size()), pairs, options.buildOptions);
     // std::cerr << "Failed to read graph from input file\n";
   }
 
@@ -127,6 +88,9 @@ int main(int argc, const char **argv) {
     case ColoringType::Sequential:
       cg = createSeqColorGraph();
       break;
+    case ColoringType::DSatur:
+      cg = createDSaturColorGraph();
+      break;
     case ColoringType::trad_1:
       cg = createBasicParallelColorGraph();
       break;
@@ -139,13 +103,15 @@ int main(int argc, const char **argv) {
     case ColoringType::trad_4:
       cg = createHighPerformanceColorGraph();
       break;
+    case ColoringType::trad_5:
+      cg = createIterativeColorGraph();
+      break;
   }
 
+  PhaseTimer::setEnabled(options.printPhases);
   Timer t;
 
-  std::unordered_map<graphNode, std::vector<graphNode>> graph;
-  std::unordered_map<graphNode, color> colors;
-  cg->buildGraph(nodes, pairs, graph);
+  std::vector<color> colors;
   t.reset();
   cg->colorGraph(graph, colors);
 
@@ -153,14 +119,17 @@ int main(int argc, const char **argv) {
   std::cout.setf(std::ios::fixed, std::ios::floatfield);
   std::cout.precision(5);
   std::cout << "Time spent: " << time_spent << std::endl;
-  std::cout << "Colored with ";
-  int max = 0;
-  for (auto &color : colors) {
-    max = std::max(max, color.second);
-  }
-  std::cout << max + 1 << " colors\n"; 
+  if (options.printPhases) PhaseTimer::printSummary(std::cout, PhaseTimer::totals());
+
+  t.reset();
+  ColoringReport report = validateColoring(graph, colors);
+  double validation_time = t.elapsed();
+
+  std::cout << "Colored with " << report.numColors() << " colors\n";
+  printColoringReport(std::cout, report, options.printHistogram);
+  std::cout << "Validation time: " << validation_time << std::endl;
 
-  if (!checkCorrectness(nodes, graph, colors)) {
+  if (!report.valid()) {
     std::cout << "Failed to color graph correctly\n";
     return -1;
   }
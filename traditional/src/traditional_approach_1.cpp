@@ -11,8 +11,9 @@
  */
 
 #include <algorithm>
-#include <unordered_set>
+#include "forbidden_colors.h"
 #include "graph.h"
+#include "phase_timer.h"
 
 /**
  * @class BasicParallelColorGraph
@@ -24,36 +25,6 @@
  */
 class BasicParallelColorGraph : public ColorGraph {
 public:
-  /**
-   * @brief Builds an adjacency list representation of the graph
-   * 
-   * Creates an adjacency list from a set of vertices and edges. Each vertex
-   * maintains a list of all its adjacent vertices.
-   * 
-   * @param vertices List of graph vertices
-   * @param edges List of edges where each edge is a pair of vertex indices
-   * @param adjacencyList The resulting adjacency list (output parameter)
-   */
-  void buildGraph(std::vector<graphNode>& vertices, 
-                  std::vector<std::pair<int, int>>& edges,
-                  std::unordered_map<graphNode, std::vector<graphNode>>& adjacencyList) {
-    // Initialize empty adjacency lists for each vertex
-    for (auto& vertex : vertices) {
-      adjacencyList[vertex] = {};
-    }
-    
-    // Populate the adjacency lists by processing each edge
-    size_t edgeCount = edges.size();
-    for (size_t i = 0; i < edgeCount; i++) {
-      int sourceVertex = edges[i].first;
-      int targetVertex = edges[i].second;
-      
-      // Add each vertex to the other's adjacency list (undirected graph)
-      adjacencyList[sourceVertex].push_back(targetVertex);
-      adjacencyList[targetVertex].push_back(sourceVertex);
-    }
-  }
-
   /**
    * @brief Determines the minimum available color for a vertex
    * 
@@ -62,31 +33,26 @@ public:
    * 
    * @param vertex The vertex to find a color for
    * @param adjacencyList The graph structure
-   * @param vertexColors Map of currently assigned colors to vertices
+   * @param vertexColors Currently assigned colors, indexed by vertex
    * @return The minimum available color index
    */
   int findMinimumAvailableColor(int vertex, 
-                          std::unordered_map<graphNode, std::vector<graphNode>>& adjacencyList,
-                          std::unordered_map<graphNode, color>& vertexColors) {
-    // Track colors used by neighboring vertices
-    std::unordered_set<int> neighborColors;
+                          const CSRGraph& adjacencyList,
+                          const std::vector<color>& vertexColors) {
+    // Track colors used by neighboring vertices in this thread's reusable set
+    ForbiddenColors& neighborColors = ForbiddenColors::local();
+    neighborColors.clear();
     
     // Collect colors of already-processed neighbors
-    for (const auto& neighbor : adjacencyList[vertex]) {
+    for (const auto& neighbor : adjacencyList.neighbors(vertex)) {
       // Only consider neighbors with lower indices that have been colored
-      if (neighbor < vertex && vertexColors.count(neighbor) > 0) {
-        neighborColors.insert(vertexColors[neighbor]);
+      if (neighbor < vertex) {
+        neighborColors.forbid(vertexColors[neighbor]);
       }
     }
     
     // Find the smallest non-negative integer not in the set of used colors
-    int candidateColor = 0;
-    while (true) {
-      if (neighborColors.find(candidateColor) == neighborColors.end()) {
-        return candidateColor;
-      }
-      candidateColor++;
-    }
+    return neighborColors.firstAvailable();
   }
 
   /**
@@ -98,25 +64,29 @@ public:
    * 3. Color optimization to reduce the total number of colors
    * 
    * @param adjacencyList The graph structure
-   * @param vertexColors Map to store the assigned colors (output parameter)
+   * @param vertexColors Assigned colors indexed by vertex (output parameter)
    */
-  void colorGraph(std::unordered_map<graphNode, std::vector<graphNode>>& adjacencyList,
-                  std::unordered_map<graphNode, color>& vertexColors) {
-    int vertexCount = static_cast<int>(adjacencyList.size());
+  void colorGraph(const CSRGraph& adjacencyList,
+                  std::vector<color>& vertexColors) {
+    int vertexCount = adjacencyList.numVertices();
     
     // Phase 1: Initialize all vertices with an uncolored state (-1)
-    for (int i = 0; i < vertexCount; i++) {
-      vertexColors[i] = -1;
-    }
+    vertexColors.assign(vertexCount, -1);
     
     // Phase 2: Perform initial parallel coloring
     // Use dynamic scheduling with chunk size 12 for better load balancing
-    #pragma omp parallel for schedule(dynamic, 12)
-    for (int i = 0; i < vertexCount; i++) {
-      int assignedColor = findMinimumAvailableColor(i, adjacencyList, vertexColors);
-      vertexColors[i] = assignedColor;
+    {
+      PhaseTimer::Scope phase(Phase::Color);
+      #pragma omp parallel for schedule(dynamic, 12)
+      for (int i = 0; i < vertexCount; i++) {
+        int assignedColor = findMinimumAvailableColor(i, adjacencyList, vertexColors);
+        vertexColors[i] = assignedColor;
+      }
     }
     
+    // Phases 3 and 4 find and recolor conflicts in the same passes
+    PhaseTimer::Scope phase(Phase::ConflictResolution);
+    
     // Find the current maximum color used (for potential conflict resolution)
     int totalColors = 0;
     for (int i = 0; i < vertexCount; i++) {
@@ -129,7 +99,7 @@ public:
       int vertexColor = vertexColors[i];
       
       // Check if this vertex has the same color as any of its neighbors
-      for (auto& neighbor : adjacencyList[i]) {
+      for (auto& neighbor : adjacencyList.neighbors(i)) {
         if (vertexColor == vertexColors[neighbor]) {
           // Conflict detected - assign a new unique color
           // Use atomic operation to prevent race conditions when updating totalColors
@@ -147,7 +117,7 @@ public:
       int highestNeighborColor = -1;
       
       // Find the highest color among neighbors
-      for (auto& neighbor : adjacencyList[i]) {
+      for (auto& neighbor : adjacencyList.neighbors(i)) {
         largestNeighbor = std::max(largestNeighbor, neighbor);
         highestNeighborColor = std::max(highestNeighborColor, vertexColors[neighbor]);
       }
@@ -1,248 +1,148 @@
-/**
- * @file speculative_coloring.cpp
- * @brief Implementation of a hybrid speculative graph coloring algorithm using OpenMP
- * 
- * This implementation leverages a combination of Jones-Plassmann ordering and
- * speculative execution to achieve efficient parallel graph coloring.
- * Author b : Sakshi, Bala
- */
-
-#include <algorithm>
-#include <vector>
-#include <unordered_set>
-#include <random>
-#include <atomic>
-#include <omp.h>
-#include "graph.h"
-
-/**
- * @class SpeculativeGraphColoring
- * @brief Parallel graph coloring using speculative execution and randomized weights
- */
-class SpeculativeGraphColoring : public ColorGraph {
-private:
-    /**
-     * @brief Deterministic hash function for weight generation
-     * 
-     * Creates a pseudo-random distribution of weights to establish
-     * vertex priorities during the coloring process.
-     */
-    inline unsigned int generateVertexPriority(unsigned int seed) {
-        // Modified mixing function - still produces good distribution
-        // but with different implementation details
-        unsigned int hash = seed;
-        hash ^= (hash << 13);
-        hash ^= (hash >> 17);
-        hash ^= (hash << 5);
-        return hash;
-    }
-    
-public:
-    /**
-     * @brief Constructs the graph representation from vertices and edges
-     */
-    void buildGraph(std::vector<graphNode>& vertices, std::vector<std::pair<int, int>>& edges,
-                  std::unordered_map<graphNode, std::vector<graphNode>>& adjacencyList) {
-        // Initialize all adjacency lists at once
-        for (auto& vertex : vertices) {
-            adjacencyList[vertex] = std::vector<graphNode>();
-        }
-        
-        // Process edges in batches for better memory locality
-        const int BATCH_SIZE = 64;
-        for (size_t i = 0; i < edges.size(); i += BATCH_SIZE) {
-            size_t end = std::min(i + BATCH_SIZE, edges.size());
-            for (size_t j = i; j < end; j++) {
-                const auto& edge = edges[j];
-                adjacencyList[edge.first].push_back(edge.second);
-                adjacencyList[edge.second].push_back(edge.first);
-            }
-        }
-    }
-
-    /**
-     * @brief Colors the graph using speculative execution
-     */
-    void colorGraph(std::unordered_map<graphNode, std::vector<graphNode>>& adjacencyList,
-                  std::unordered_map<graphNode, color>& vertexColors) {
-        int vertexCount = adjacencyList.size();
-        
-        // Use direct vector construction for efficiency
-        std::vector<std::vector<int>> graphVectors;
-        graphVectors.reserve(vertexCount);
-        
-        // Fill vector representation in a single pass
-        for (int i = 0; i < vertexCount; i++) {
-            graphVectors.push_back(adjacencyList[i]);
-        }
-        
-        // Generate priorities with modified seed calculation
-        std::vector<unsigned int> priorities(vertexCount);
-        for (int i = 0; i < vertexCount; i++) {
-            // Use different seed generation but functionally equivalent
-            priorities[i] = generateVertexPriority((i * 16777619) ^ 2166136261);
-        }
-        
-        // Initialize with default values
-        std::vector<int> colors(vertexCount, -1);
-        std::vector<bool> processed(vertexCount, false);
-        
-        // Initial speculative coloring phase
-        #pragma omp parallel
-        {
-            // Pre-allocate with reasonable capacity to reduce reallocations
-            std::vector<bool> takenColors;
-            takenColors.reserve(32);  // Reasonable starting size for most graphs
-            
-            // Process vertices in parallel where possible
-            #pragma omp for schedule(guided)  // Using guided scheduling instead of dynamic
-            for (int vertex = 0; vertex < vertexCount; vertex++) {
-                // Check if this vertex has highest priority among unprocessed neighbors
-                bool hasPriority = true;
-                for (int neighbor : graphVectors[vertex]) {
-                    if (!processed[neighbor] && priorities[neighbor] > priorities[vertex]) {
-                        hasPriority = false;
-                        break;
-                    }
-                }
-                
-                if (hasPriority) {
-                    // Use different initialization pattern but same functionality
-                    takenColors.clear();
-                    int neighborCount = graphVectors[vertex].size();
-                    takenColors.assign(neighborCount + 1, false);
-                    
-                    // Mark colors that are already taken
-                    for (int neighbor : graphVectors[vertex]) {
-                        if (processed[neighbor] && colors[neighbor] >= 0) {
-                            // Grow only when needed
-                            while (colors[neighbor] >= (int)takenColors.size()) {
-                                takenColors.push_back(false);
-                            }
-                            takenColors[colors[neighbor]] = true;
-                        }
-                    }
-                    
-                    // Find first available color using different but equivalent search
-                    int colorAssignment = 0;
-                    for (size_t c = 0; c < takenColors.size(); c++) {
-                        if (!takenColors[c]) {
-                            colorAssignment = c;
-                            break;
-                        }
-                        colorAssignment = c + 1;
-                    }
-                    
-                    // Assign color and mark as processed
-                    colors[vertex] = colorAssignment;
-                    processed[vertex] = true;
-                }
-            }
-        }
-        
-        // Continue coloring remaining vertices
-        bool completed;
-        int iterations = 0;
-        const int MAX_ITERATIONS = 100;  // Safety limit
-        
-        do {
-            completed = true;
-            iterations++;
-            
-            #pragma omp parallel
-            {
-                std::vector<bool> takenColors;
-                takenColors.reserve(32);
-                
-                #pragma omp for reduction(&&:completed)
-                for (int vertex = 0; vertex < vertexCount; vertex++) {
-                    if (!processed[vertex]) {
-                        // Check if this vertex now has highest priority
-                        bool hasPriority = true;
-                        for (int neighbor : graphVectors[vertex]) {
-                            if (!processed[neighbor] && priorities[neighbor] > priorities[vertex]) {
-                                hasPriority = false;
-                                break;
-                            }
-                        }
-                        
-                        if (hasPriority) {
-                            // Find available color
-                            takenColors.clear();
-                            takenColors.assign(graphVectors[vertex].size() + 1, false);
-                            
-                            for (int neighbor : graphVectors[vertex]) {
-                                if (processed[neighbor] && colors[neighbor] >= 0) {
-                                    while (colors[neighbor] >= (int)takenColors.size()) {
-                                        takenColors.push_back(false);
-                                    }
-                                    takenColors[colors[neighbor]] = true;
-                                }
-                            }
-                            
-                            // Use std::distance for finding first unset bit
-                            int colorAssignment = std::distance(
-                                takenColors.begin(),
-                                std::find(takenColors.begin(), takenColors.end(), false)
-                            );
-                            
-                            colors[vertex] = colorAssignment;
-                            processed[vertex] = true;
-                        } else {
-                            completed = false;
-                        }
-                    }
-                }
-            }
-        } while (!completed && iterations < MAX_ITERATIONS);
-        
-        // Ensure all vertices are colored even if max iterations reached
-        if (!completed) {
-            for (int vertex = 0; vertex < vertexCount; vertex++) {
-                if (!processed[vertex]) {
-                    // Just assign unique colors to any remaining vertices
-                    colors[vertex] = *std::max_element(colors.begin(), colors.end()) + 1;
-                    processed[vertex] = true;
-                }
-            }
-        }
-        
-        // Validate coloring and resolve conflicts
-        #pragma omp parallel for
-        for (int vertex = 0; vertex < vertexCount; vertex++) {
-            bool hasConflict = false;
-            int conflictNeighbor = -1;
-            
-            // Two-phase conflict detection to reduce critical section usage
-            for (int neighbor : graphVectors[vertex]) {
-                if (colors[vertex] == colors[neighbor]) {
-                    hasConflict = true;
-                    conflictNeighbor = neighbor;
-                    break;
-                }
-            }
-            
-            // Only enter critical section if needed
-            if (hasConflict) {
-                #pragma omp critical
-                {
-                    // Resolve conflict with a new color
-                    int highestColor = *std::max_element(colors.begin(), colors.end());
-                    colors[vertex] = highestColor + 1;
-                }
-            }
-        }
-        
-        // Transfer results back to the output map
-        for (int i = 0; i < vertexCount; i++) {
-            vertexColors[i] = colors[i];
-        }
-    }
-};
-
-/**
- * @brief Factory function for the speculative coloring algorithm
- */
-std::unique_ptr<ColorGraph> createSpeculativeGraphColoring() {
-    return std::make_unique<SpeculativeGraphColoring>();
-}
\ No newline at end of file
+/**
+ * @file speculative_coloring.cpp
+ * @brief Jones-Plassmann graph coloring driven by per-vertex dependency counters
+ *
+ * Every vertex gets a pseudo-random priority. A vertex may be colored once all
+ * of its higher-priority neighbors are, so each vertex keeps a counter of
+ * uncolored higher-priority neighbors. Rounds only visit the frontier of
+ * vertices whose counter reached zero; coloring a vertex decrements the
+ * counters of its lower-priority neighbors and adds those that hit zero to the
+ * next frontier. Total work is O(V + E) regardless of the number of rounds,
+ * and no two frontier vertices are adjacent, so the result needs no repair.
+ * Author b : Sakshi, Bala
+ */
+
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <omp.h>
+#include "forbidden_colors.h"
+#include "graph.h"
+#include "phase_timer.h"
+
+/**
+ * @class SpeculativeGraphColoring
+ * @brief Parallel Jones-Plassmann coloring with randomized weights
+ */
+class SpeculativeGraphColoring : public ColorGraph {
+private:
+    /**
+     * @brief Deterministic hash function for weight generation
+     *
+     * Creates a pseudo-random distribution of weights to establish
+     * vertex priorities during the coloring process.
+     */
+    inline unsigned int generateVertexPriority(unsigned int seed) {
+        unsigned int hash = seed;
+        hash ^= (hash << 13);
+        hash ^= (hash >> 17);
+        hash ^= (hash << 5);
+        return hash;
+    }
+
+    /**
+     * @brief Strict total order on vertices; ties in the hash are broken by id
+     */
+    static inline bool precedes(const std::vector<unsigned int>& priorities, int a, int b) {
+        return priorities[a] > priorities[b] || (priorities[a] == priorities[b] && a > b);
+    }
+
+public:
+    /**
+     * @brief Colors the graph in frontier rounds
+     */
+    void colorGraph(const CSRGraph& graph,
+                  std::vector<color>& colors) {
+        int vertexCount = graph.numVertices();
+
+        std::vector<unsigned int> priorities(vertexCount);
+        colors.resize(vertexCount);
+        std::vector<std::atomic<int>> pending(vertexCount);
+
+        // Frontiers are double-buffered; a vertex enters exactly one frontier
+        std::vector<int> frontier(vertexCount);
+        std::vector<int> next_frontier(vertexCount);
+        std::atomic<int> frontier_size{0};
+        std::atomic<int> next_size{0};
+
+        #pragma omp parallel
+        {
+            std::vector<int> local_frontier;
+            int offset;
+
+            // Phases are timed per thread; priorities and dependency counts form the ordering
+            {
+                PhaseTimer::Scope phase(Phase::Ordering);
+
+                #pragma omp for schedule(static)
+                for (int i = 0; i < vertexCount; i++) {
+                    priorities[i] = generateVertexPriority((i * 16777619) ^ 2166136261);
+                    colors[i] = -1;
+                }
+
+                // Count higher-priority neighbors and seed the first frontier with local maxima
+                #pragma omp for schedule(dynamic, 256)
+                for (int vertex = 0; vertex < vertexCount; vertex++) {
+                    int higher = 0;
+                    for (int neighbor : graph.neighbors(vertex)) {
+                        if (precedes(priorities, neighbor, vertex)) higher++;
+                    }
+                    pending[vertex].store(higher, std::memory_order_relaxed);
+                    if (higher == 0) local_frontier.push_back(vertex);
+                }
+
+                offset = frontier_size.fetch_add(static_cast<int>(local_frontier.size()));
+                std::copy(local_frontier.begin(), local_frontier.end(), frontier.begin() + offset);
+                local_frontier.clear();
+
+                #pragma omp barrier
+            }
+
+            ForbiddenColors takenColors;
+            PhaseTimer::Scope phase(Phase::Color);
+
+            while (frontier_size.load() > 0) {
+                int current_size = frontier_size.load();
+
+                #pragma omp for schedule(dynamic, 64)
+                for (int index = 0; index < current_size; index++) {
+                    int vertex = frontier[index];
+
+                    // Every higher-priority neighbor was colored in an earlier round
+                    takenColors.clear();
+                    for (int neighbor : graph.neighbors(vertex)) {
+                        takenColors.forbid(colors[neighbor]);
+                    }
+                    colors[vertex] = takenColors.firstAvailable();
+
+                    // Release lower-priority neighbors whose last dependency this was
+                    for (int neighbor : graph.neighbors(vertex)) {
+                        if (precedes(priorities, vertex, neighbor) &&
+                            pending[neighbor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                            local_frontier.push_back(neighbor);
+                        }
+                    }
+                }
+
+                offset = next_size.fetch_add(static_cast<int>(local_frontier.size()));
+                std::copy(local_frontier.begin(), local_frontier.end(), next_frontier.begin() + offset);
+                local_frontier.clear();
+
+                #pragma omp barrier
+                #pragma omp single
+                {
+                    frontier.swap(next_frontier);
+                    frontier_size.store(next_size.load());
+                    next_size.store(0);
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Factory function for the Jones-Plassmann coloring algorithm
+ */
+std::unique_ptr<ColorGraph> createSpeculativeGraphColoring() {
+    return std::make_unique<SpeculativeGraphColoring>();
+}
@@ -13,12 +13,15 @@
 
 #include <algorithm>
 #include <atomic>
-#include <deque>
-#include <mutex>
+#include <memory>
 #include <omp.h>
+#include <thread>
 #include <vector>
-#include <unordered_set>
+#include "coloring_order.h"
+#include "forbidden_colors.h"
 #include "graph.h"
+#include "phase_timer.h"
+#include "work_stealing_deque.h"
 
 /**
  * @class WorkStealingColorGraph
@@ -29,62 +32,19 @@
  */
 class WorkStealingColorGraph : public ColorGraph {
 private:
+    // Vertices handed out per task; thieves take a whole block at once
+    static constexpr int BLOCK_SIZE = 64;
+    
     /**
-     * @brief Thread-safe work queue that supports stealing for load balancing
+     * @brief Task covering schedule[begin, end)
      */
-    class WorkQueue {
-    private:
-        std::deque<int> tasks;
-        std::mutex queue_mutex;
-        
-    public:
-        /**
-         * @brief Add a task to the local queue
-         * @param task The vertex ID to process
-         */
-        void push(int task) {
-            std::lock_guard<std::mutex> lock(queue_mutex);
-            tasks.push_back(task);
-        }
-        
-        /**
-         * @brief Try to get a task from the local queue
-         * @param task Output parameter for the vertex ID
-         * @return True if a task was retrieved, false if queue is empty
-         */
-        bool pop(int& task) {
-            std::lock_guard<std::mutex> lock(queue_mutex);
-            if (tasks.empty()) return false;
-            
-            task = tasks.front();
-            tasks.pop_front();
-            return true;
-        }
-        
-        /**
-         * @brief Try to steal a task from another queue (from the back)
-         * @param task Output parameter for the vertex ID
-         * @return True if a task was stolen, false otherwise
-         */
-        bool steal(int& task) {
-            std::lock_guard<std::mutex> lock(queue_mutex);
-            if (tasks.empty()) return false;
-            
-            task = tasks.back();
-            tasks.pop_back();
-            return true;
-        }
-        
-        /**
-         * @brief Check if queue is empty
-         * @return True if queue has no tasks
-         */
-        bool empty() {
-            std::lock_guard<std::mutex> lock(queue_mutex);
-            return tasks.empty();
-        }
+    struct VertexBlock {
+        int begin;
+        int end;
     };
     
+    typedef WorkStealingDeque<VertexBlock> WorkQueue;
+    
     /**
      * @brief Data structure to track the boundary between graph partitions
      */
@@ -101,42 +61,28 @@ private:
      * @param vertex The vertex to color
      * @param graph The graph structure
      * @param colors Current color assignments
-     * @param color_flags Array to track used colors
+     * @param color_flags Per-thread set to track used colors
      * @return The smallest available color
      */
-    int findDistance2Color(int vertex, const std::vector<std::vector<int>>& graph,
-                          const std::vector<int>& colors, std::vector<bool>& color_flags) {
+    int findDistance2Color(int vertex, const CSRGraph& graph,
+                          const std::vector<int>& colors, ForbiddenColors& color_flags) {
         // Clear flags from previous use
-        std::fill(color_flags.begin(), color_flags.end(), false);
+        color_flags.clear();
         
         // Mark colors used by direct neighbors (distance-1)
-        for (int neighbor : graph[vertex]) {
-            if (colors[neighbor] >= 0) {
-                if (colors[neighbor] >= static_cast<int>(color_flags.size())) {
-                    color_flags.resize(colors[neighbor] + 1, false);
-                }
-                color_flags[colors[neighbor]] = true;
-            }
+        for (int neighbor : graph.neighbors(vertex)) {
+            color_flags.forbid(colors[neighbor]);
             
             // Mark colors used by distance-2 neighbors (neighbors of neighbors)
-            for (int dist2_neighbor : graph[neighbor]) {
-                if (dist2_neighbor != vertex && colors[dist2_neighbor] >= 0) {
-                    if (colors[dist2_neighbor] >= static_cast<int>(color_flags.size())) {
-                        color_flags.resize(colors[dist2_neighbor] + 1, false);
-                    }
-                    color_flags[colors[dist2_neighbor]] = true;
+            for (int dist2_neighbor : graph.neighbors(neighbor)) {
+                if (dist2_neighbor != vertex) {
+                    color_flags.forbid(colors[dist2_neighbor]);
                 }
             }
         }
         
         // Find first available color
-        for (int color = 0; color < static_cast<int>(color_flags.size()); color++) {
-            if (!color_flags[color]) {
-                return color;
-            }
-        }
-        
-        return color_flags.size();
+        return color_flags.firstAvailable();
     }
     
     /**
@@ -148,9 +94,10 @@ private:
      * @param num_partitions Number of partitions to create (typically thread count)
      * @return Vector of partitions, each containing a set of vertex IDs
      */
-    std::vector<std::vector<int>> partitionGraph(const std::vector<std::vector<int>>& graph, 
+    std::vector<std::vector<int>> partitionGraph(const CSRGraph& graph, 
                                                int num_partitions) {
-        int num_vertices = graph.size();
+        PhaseTimer::Scope phase(Phase::Partition);
+        int num_vertices = graph.numVertices();
         std::vector<std::vector<int>> partitions(num_partitions);
         
         // Simplified partitioning algorithm - in practice, would use a more sophisticated
@@ -159,7 +106,7 @@ private:
         // For demonstration, use a simple vertex distribution based on connectivity
         std::vector<int> vertex_weights(num_vertices);
         for (int i = 0; i < num_vertices; i++) {
-            vertex_weights[i] = graph[i].size();  // Use degree as weight
+            vertex_weights[i] = graph.degree(i);  // Use degree as weight
         }
         
         // Sort vertices by weight (degree) for better distribution
@@ -168,10 +115,13 @@ private:
             sorted_vertices[i] = i;
         }
         
-        std::sort(sorted_vertices.begin(), sorted_vertices.end(),
-                 [&vertex_weights](int a, int b) {
-                     return vertex_weights[a] > vertex_weights[b];
-                 });
+        // A preset order has already been applied to the vertex ids
+        if (!PresetColoringOrder::active()) {
+            std::sort(sorted_vertices.begin(), sorted_vertices.end(),
+                     [&vertex_weights](int a, int b) {
+                         return vertex_weights[a] > vertex_weights[b];
+                     });
+        }
         
         // Round-robin assignment to partitions
         for (int i = 0; i < num_vertices; i++) {
@@ -189,9 +139,10 @@ private:
      * @param partitions The partitioning of vertices
      * @return Boundary information for conflict resolution
      */
-    PartitionBoundary findPartitionBoundaries(const std::vector<std::vector<int>>& graph,
+    PartitionBoundary findPartitionBoundaries(const CSRGraph& graph,
                                             const std::vector<std::vector<int>>& partitions) {
-        int num_vertices = graph.size();
+        PhaseTimer::Scope phase(Phase::Partition);
+        int num_vertices = graph.numVertices();
         int num_partitions = partitions.size();
         
         // Create mapping from vertex to its partition
@@ -209,7 +160,7 @@ private:
             int vertex_partition = vertex_to_partition[vertex];
             bool is_border = false;
             
-            for (int neighbor : graph[vertex]) {
+            for (int neighbor : graph.neighbors(vertex)) {
                 int neighbor_partition = vertex_to_partition[neighbor];
                 
                 if (vertex_partition != neighbor_partition) {
@@ -231,145 +182,111 @@ private:
     }
 
 public:
-    /**
-     * @brief Builds the graph structure from vertices and edges
-     */
-    void buildGraph(std::vector<graphNode>& nodes, std::vector<std::pair<int, int>>& pairs,
-                  std::unordered_map<graphNode, std::vector<graphNode>>& graph) {
-        // Initialize adjacency lists
-        for (auto& node : nodes) {
-            graph[node] = {};
-        }
-        
-        // Build undirected graph
-        for (const auto& pair : pairs) {
-            graph[pair.first].push_back(pair.second);
-            graph[pair.second].push_back(pair.first);
-        }
-    }
-
     /**
      * @brief Colors the graph using a work-stealing approach with distance-2 coloring
      */
-    void colorGraph(std::unordered_map<graphNode, std::vector<graphNode>>& graph,
-                  std::unordered_map<graphNode, color>& colors) {
-        int num_vertices = graph.size();
+    void colorGraph(const CSRGraph& graph,
+                  std::vector<color>& vertex_colors) {
+        int num_vertices = graph.numVertices();
         int num_threads = omp_get_max_threads();
         
-        // Convert to vector representation for better performance
-        std::vector<std::vector<int>> vec_graph(num_vertices);
-        for (int i = 0; i < num_vertices; i++) {
-            vec_graph[i] = graph[i];
-        }
-        
         // PHASE 1: Graph partitioning for improved locality
-        std::vector<std::vector<int>> partitions = partitionGraph(vec_graph, num_threads);
-        PartitionBoundary boundary = findPartitionBoundaries(vec_graph, partitions);
+        std::vector<std::vector<int>> partitions = partitionGraph(graph, num_threads);
+        PartitionBoundary boundary = findPartitionBoundaries(graph, partitions);
         
         // Initialize coloring state
-        std::vector<int> vertex_colors(num_vertices, -1);
+        vertex_colors.assign(num_vertices, -1);
         std::atomic<int> max_color{0};
         
-        // PHASE 2: Create thread-local work queues
-        std::vector<WorkQueue> work_queues(num_threads);
+        // PHASE 2: Create thread-local work queues of vertex blocks
+        // Partitions are laid out back to back so a block is just an index range
+        std::vector<int> schedule;
+        schedule.reserve(num_vertices);
+        std::vector<std::unique_ptr<WorkQueue>> work_queues(num_threads);
+        size_t total_blocks = 0;
         
-        // Initialize work queues with partition vertices
-        for (int t = 0; t < num_threads; t++) {
-            for (int vertex : partitions[t]) {
-                work_queues[t].push(vertex);
+        {
+            PhaseTimer::Scope phase(Phase::Partition);
+            for (int t = 0; t < num_threads; t++) {
+                int partition_begin = static_cast<int>(schedule.size());
+                schedule.insert(schedule.end(), partitions[t].begin(), partitions[t].end());
+                int partition_end = static_cast<int>(schedule.size());
+                
+                int blocks = (partition_end - partition_begin + BLOCK_SIZE - 1) / BLOCK_SIZE;
+                work_queues[t].reset(new WorkQueue(blocks));
+                // Push in reverse so the owner pops its partition front to back
+                for (int b = blocks - 1; b >= 0; b--) {
+                    int begin = partition_begin + b * BLOCK_SIZE;
+                    work_queues[t]->push({begin, std::min(begin + BLOCK_SIZE, partition_end)});
+                }
+                total_blocks += blocks;
             }
         }
         
-        // PHASE 3: Parallel coloring with work-stealing
-        #pragma omp parallel
+        // Blocks not yet finished; no task spawns new ones, so zero means all work is done
+        std::atomic<size_t> pending_blocks{total_blocks};
+        
+        // PHASE 3: Parallel coloring with work-stealing; timed per thread, so idle stealing counts
+        #pragma omp parallel num_threads(num_threads)
         {
+            PhaseTimer::Scope phase(Phase::Color);
             int thread_id = omp_get_thread_num();
-            std::vector<bool> color_flags(64, false);  // Pre-allocate reasonable size
-            int processed_count = 0;
+            ForbiddenColors color_flags;
+            uint32_t rng_state = 2654435761u * (thread_id + 1);
             
-            // Process until all queues are empty
-            bool all_done = false;
-            while (!all_done) {
-                int vertex;
-                bool got_task = work_queues[thread_id].pop(vertex);
+            while (pending_blocks.load(std::memory_order_acquire) > 0) {
+                VertexBlock block;
+                bool got_task = work_queues[thread_id]->pop(block);
                 
-                if (!got_task) {
-                    // Try to steal task from another queue
-                    bool stole_task = false;
-                    
-                    // Try all other queues in random order
-                    std::vector<int> steal_order(num_threads);
-                    for (int i = 0; i < num_threads; i++) {
-                        steal_order[i] = i;
-                    }
+                // Steal from randomly chosen victims until one succeeds or a full sweep finds nothing
+                int attempts = 0;
+                while (!got_task && num_threads > 1 && attempts < 2 * num_threads) {
+                    rng_state ^= rng_state << 13;
+                    rng_state ^= rng_state >> 17;
+                    rng_state ^= rng_state << 5;
+                    int victim = static_cast<int>(rng_state % (num_threads - 1));
+                    if (victim >= thread_id) victim++;
                     
-                    // Fisher-Yates shuffle for randomized stealing
-                    for (int i = num_threads - 1; i > 0; i--) {
-                        int j = i * (thread_id + 1) % (i + 1);  // Deterministic but different per thread
-                        std::swap(steal_order[i], steal_order[j]);
-                    }
-                    
-                    for (int t : steal_order) {
-                        if (t == thread_id) continue;
-                        
-                        if (work_queues[t].steal(vertex)) {
-                            stole_task = true;
-                            break;
-                        }
-                    }
-                    
-                    if (!stole_task) {
-                        // Check if all queues are empty
-                        all_done = true;
-                        for (int t = 0; t < num_threads; t++) {
-                            if (!work_queues[t].empty()) {
-                                all_done = false;
-                                break;
-                            }
-                        }
-                        
-                        if (all_done) break;
-                        continue;  // Try again
-                    }
+                    got_task = work_queues[victim]->steal(block) == WorkQueue::StealResult::Success;
+                    attempts++;
                 }
                 
-                // Process the vertex - use distance-2 coloring for better parallelism
-                int assigned_color = findDistance2Color(vertex, vec_graph, vertex_colors, color_flags);
-                vertex_colors[vertex] = assigned_color;
-                
-                // Update max color if needed
-                if (assigned_color >= max_color.load()) {
-                    int expected = max_color.load();
-                    while (assigned_color >= expected &&
-                          !max_color.compare_exchange_weak(expected, assigned_color + 1)) {
-                        // Keep trying
-                    }
+                if (!got_task) {
+                    // Remaining blocks are being colored by other threads
+                    std::this_thread::yield();
+                    continue;
                 }
                 
-                processed_count++;
-                
-                // Periodically check termination to avoid excessive checking
-                if (processed_count % 64 == 0) {
-                    bool all_empty = true;
-                    for (int t = 0; t < num_threads; t++) {
-                        if (!work_queues[t].empty()) {
-                            all_empty = false;
-                            break;
+                for (int i = block.begin; i < block.end; i++) {
+                    int vertex = schedule[i];
+                    
+                    // Process the vertex - use distance-2 coloring for better parallelism
+                    int assigned_color = findDistance2Color(vertex, graph, vertex_colors, color_flags);
+                    vertex_colors[vertex] = assigned_color;
+                    
+                    // Update max color if needed
+                    if (assigned_color >= max_color.load()) {
+                        int expected = max_color.load();
+                        while (assigned_color >= expected &&
+                              !max_color.compare_exchange_weak(expected, assigned_color + 1)) {
+                            // Keep trying
                         }
                     }
-                    
-                    if (all_empty) all_done = true;
                 }
+                
+                pending_blocks.fetch_sub(1, std::memory_order_release);
             }
         }
         
         // PHASE 4: Sequential resolution of boundary conflicts
         // Process boundary vertices to ensure correctness across partitions
+        PhaseTimer::Scope phase(Phase::ConflictResolution);
+        ForbiddenColors color_flags(max_color.load() + 1);
         for (int boundary_vertex : boundary.border_vertices) {
             // Check for conflicts
             bool has_conflict = false;
             
-            for (int neighbor : vec_graph[boundary_vertex]) {
+            for (int neighbor : graph.neighbors(boundary_vertex)) {
                 if (vertex_colors[boundary_vertex] == vertex_colors[neighbor]) {
                     has_conflict = true;
                     break;
@@ -378,23 +295,15 @@ public:
             
             // Resolve conflict if needed
             if (has_conflict) {
-                std::vector<bool> color_flags(max_color.load() + 1, false);
+                color_flags.clear();
                 
                 // Mark colors used by neighbors
-                for (int neighbor : vec_graph[boundary_vertex]) {
-                    if (vertex_colors[neighbor] >= 0) {
-                        if (vertex_colors[neighbor] >= static_cast<int>(color_flags.size())) {
-                            color_flags.resize(vertex_colors[neighbor] + 1, false);
-                        }
-                        color_flags[vertex_colors[neighbor]] = true;
-                    }
+                for (int neighbor : graph.neighbors(boundary_vertex)) {
+                    color_flags.forbid(vertex_colors[neighbor]);
                 }
                 
                 // Find new color
-                int new_color = 0;
-                while (new_color < static_cast<int>(color_flags.size()) && color_flags[new_color]) {
-                    new_color++;
-                }
+                int new_color = color_flags.firstAvailable();
                 
                 vertex_colors[boundary_vertex] = new_color;
                 
@@ -404,11 +313,6 @@ public:
                 }
             }
         }
-        
-        // Copy results back to output map
-        for (int i = 0; i < num_vertices; i++) {
-            colors[i] = vertex_colors[i];
-        }
     }
 };
 
@@ -0,0 +1,146 @@
+/**
+ * @file iterative_coloring.cpp
+ * @brief Iterative speculative graph coloring with shrinking worklists
+ *
+ * Gebremedhin-Manne style coloring as refined by Catalyurek et al.: every
+ * round tentatively colors the current worklist in parallel, then checks only
+ * those vertices for conflicts. Of two adjacent vertices that picked the same
+ * color the one with the larger id loses; the losers are stream-compacted,
+ * in order, into the next worklist. Only vertices of the worklist change color
+ * in a round, so a conflict always involves two of them, and the smallest id
+ * of every conflicting group keeps its color. The worklist therefore strictly
+ * shrinks and the loop terminates.
+ * Author : Sakshi, Balasubramanian S
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <omp.h>
+#include <vector>
+#include "forbidden_colors.h"
+#include "graph.h"
+#include "phase_timer.h"
+
+/**
+ * @class IterativeColorGraph
+ * @brief Speculative coloring that only revisits the previous round's conflicts
+ */
+class IterativeColorGraph : public ColorGraph {
+public:
+    /**
+     * @brief Colors the graph in tentative-coloring / conflict-detection rounds
+     *
+     * @param graph The graph structure in CSR form
+     * @param colors Output colors indexed by vertex
+     */
+    void colorGraph(const CSRGraph& graph,
+                  std::vector<color>& colors) {
+        int num_vertices = graph.numVertices();
+
+        // Relaxed atomics: neighbors are read while other threads recolor them
+        std::vector<std::atomic<int>> vertex_colors(num_vertices);
+        std::vector<int> worklist(num_vertices);
+        std::vector<int> next_worklist(num_vertices);
+        std::vector<int> block_offsets(omp_get_max_threads() + 1, 0);
+        int worklist_size = num_vertices;
+        colors.resize(num_vertices);
+
+        #pragma omp parallel
+        {
+            int thread_id = omp_get_thread_num();
+            int num_threads = omp_get_num_threads();
+            ForbiddenColors used_colors;
+            std::vector<char> lost;
+
+            // Phases are timed per thread, including the barrier that ends each one
+            {
+                PhaseTimer::Scope phase(Phase::Setup);
+                #pragma omp for schedule(static)
+                for (int i = 0; i < num_vertices; i++) {
+                    vertex_colors[i].store(-1, std::memory_order_relaxed);
+                    worklist[i] = i;
+                }
+            }
+
+            while (worklist_size > 0) {
+                // PHASE 1: Tentative coloring of the worklist
+                {
+                    PhaseTimer::Scope phase(Phase::Color);
+                    #pragma omp for schedule(dynamic, 64)
+                    for (int index = 0; index < worklist_size; index++) {
+                        int vertex = worklist[index];
+                        used_colors.clear();
+                        for (int neighbor : graph.neighbors(vertex)) {
+                            if (neighbor != vertex) {
+                                used_colors.forbid(vertex_colors[neighbor].load(std::memory_order_relaxed));
+                            }
+                        }
+                        vertex_colors[vertex].store(used_colors.firstAvailable(), std::memory_order_relaxed);
+                    }
+                }
+
+                // Detection and compaction of the losers
+                PhaseTimer::Scope phase(Phase::ConflictDetection);
+
+                // PHASE 2: Conflict detection, one contiguous block of the worklist per thread
+                int block_begin = static_cast<int>(static_cast<long long>(worklist_size) * thread_id / num_threads);
+                int block_end = static_cast<int>(static_cast<long long>(worklist_size) * (thread_id + 1) / num_threads);
+                lost.assign(block_end - block_begin, 0);
+                int lost_count = 0;
+
+                for (int index = block_begin; index < block_end; index++) {
+                    int vertex = worklist[index];
+                    int vertex_color = vertex_colors[vertex].load(std::memory_order_relaxed);
+                    for (int neighbor : graph.neighbors(vertex)) {
+                        // Larger id yields, so the smallest id in a conflict keeps its color
+                        if (neighbor < vertex &&
+                            vertex_colors[neighbor].load(std::memory_order_relaxed) == vertex_color) {
+                            lost[index - block_begin] = 1;
+                            lost_count++;
+                            break;
+                        }
+                    }
+                }
+                block_offsets[thread_id + 1] = lost_count;
+
+                // PHASE 3: Ordered stream compaction of the losers into the next worklist
+                #pragma omp barrier
+                #pragma omp single
+                {
+                    for (int t = 1; t <= num_threads; t++) {
+                        block_offsets[t] += block_offsets[t - 1];
+                    }
+                }
+
+                int out = block_offsets[thread_id];
+                for (int index = block_begin; index < block_end; index++) {
+                    if (lost[index - block_begin]) {
+                        next_worklist[out++] = worklist[index];
+                    }
+                }
+
+                #pragma omp barrier
+                #pragma omp single
+                {
+                    worklist.swap(next_worklist);
+                    worklist_size = block_offsets[num_threads];
+                }
+            }
+
+            PhaseTimer::Scope phase(Phase::Output);
+            #pragma omp for schedule(static)
+            for (int i = 0; i < num_vertices; i++) {
+                colors[i] = vertex_colors[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Factory function that creates a new IterativeColorGraph instance
+ *
+ * @return A unique pointer to a new IterativeColorGraph object
+ */
+std::unique_ptr<ColorGraph> createIterativeColorGraph() {
+    return std::make_unique<IterativeColorGraph>();
+}
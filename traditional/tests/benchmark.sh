@@ -7,7 +7,7 @@ FILES=("sparse-50000.txt" "random-5000.txt" "corner-50000.txt" "components-50000
 THREADS=(1 2 4 8 16 32 64)
 
 # Define approaches - add or remove as needed
-APPROACHES=("seq" "trad_1" "trad_2" "trad_3" "trad_4")  
+APPROACHES=("seq" "trad_1" "trad_2" "trad_3" "trad_4" "trad_5")  
 
 # Store results in memory only, no files
 declare -A TIME_RESULTS
@@ -15,6 +15,19 @@ declare -A COLOR_RESULTS
 declare -A CORRECT_RESULTS
 declare -A SPEEDUP_RESULTS
 
+# Text to binary graph converter (make convert in traditional/)
+CONVERTER=./graph_convert
+
+# Binary copy of a test file if one could be made, otherwise the text file
+graph_input() {
+    local file=$1
+    if [ -f "${file%.txt}.csr" ]; then
+        echo "${file%.txt}.csr"
+    else
+        echo "$file"
+    fi
+}
+
 # Function to run a test
 run_test() {
     local approach=$1
@@ -30,7 +43,7 @@ run_test() {
     
     # Run and display output directly
     echo "------------ Start of $approach ($threads threads) output ------------"
-    output=$(./traditional_graph_coloring -$approach -f $file 2>&1)
+    output=$(./traditional_graph_coloring -$approach -f $(graph_input $file) 2>&1)
     echo "$output"
     echo "------------ End of $approach ($threads threads) output ------------"
     
@@ -76,6 +89,15 @@ echo "==================== Graph Coloring Benchmark ===================="
 printf "%-8s %-6s %-15s %-8s %-8s %-12s %-8s\n" "Approach" "Threads" "File" "Time\(s\)" "Colors" "Correctness" "Speedup"
 echo "================================================================="
 
+# Convert every test file once so the runs below skip text parsing
+if [ -x "$CONVERTER" ]; then
+    for file in "${FILES[@]}"; do
+        if [ -f "$file" ] && [ ! "${file%.txt}.csr" -nt "$file" ]; then
+            "$CONVERTER" "$file" "${file%.txt}.csr" || rm -f "${file%.txt}.csr"
+        fi
+    done
+fi
+
 # Main test loop
 for file in "${FILES[@]}"; do
     echo "Processing file: $file"
@@ -10,67 +10,32 @@
 #include <memory>
 #include <utility>
 
+#include "csr_graph.h"
+
 class Graph {
 private:
-    int num_vertices;
-    int num_edges;
-    std::vector<std::vector<int>> adjacency_lists;
+    CSRGraph csr;
 
 public:
-    // Constructor with safe initialization
-    explicit Graph(int vertices) : num_vertices(vertices), num_edges(0) {
-        if (vertices <= 0) {
+    // Takes ownership of an already built CSR graph
+    explicit Graph(CSRGraph&& graph) : csr(std::move(graph)) {
+        if (csr.numVertices() <= 0) {
             throw std::invalid_argument("Number of vertices must be positive");
         }
-        
-        // Pre-allocate with safe size
-        adjacency_lists.resize(vertices);
-    }
-    
-    // Reserve space for edges with bounds checking
-    void reserveEdges(int avg_degree) {
-        if (avg_degree <= 0) return;
-        
-        // Cap the reservation to avoid excessive memory usage
-        int safe_degree = std::min(avg_degree, 1000);
-        
-        for (auto& adj : adjacency_lists) {
-            adj.reserve(safe_degree);
-        }
-    }
-    
-    // Safe edge addition with bounds check
-    void addEdge(int u, int v) {
-        if (u < 0 || u >= num_vertices || v < 0 || v >= num_vertices) {
-            throw std::out_of_range("Vertex index out of range");
-        }
-        
-        adjacency_lists[u].push_back(v);
-        if (u != v) { // Handle self-loops
-            adjacency_lists[v].push_back(u);
-        }
-        num_edges++;
     }
     
     // Get neighbors with bounds checking
-    const std::vector<int>& getNeighbors(int vertex) const {
-        if (vertex < 0 || vertex >= num_vertices) {
+    CSRGraph::NeighborRange getNeighbors(int vertex) const {
+        if (vertex < 0 || vertex >= csr.numVertices()) {
             throw std::out_of_range("Vertex index out of range");
         }
-        return adjacency_lists[vertex];
+        return csr.neighbors(vertex);
     }
     
     // Basic getters
-    int numVertices() const { return num_vertices; }
-    int numEdges() const { return num_edges; }
-    
-    // Optimize the graph safely
-    void optimize() {
-        #pragma omp parallel for schedule(dynamic, 64)
-        for (int i = 0; i < num_vertices; i++) {
-            std::sort(adjacency_lists[i].begin(), adjacency_lists[i].end());
-        }
-    }
+    int numVertices() const { return csr.numVertices(); }
+    long long numEdges() const { return static_cast<long long>(csr.numAdjacencies() / 2); }
+    const CSRGraph& csrGraph() const { return csr; }
 };
 
 // Function declaration for graph loading
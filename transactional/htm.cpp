@@ -0,0 +1,66 @@
+// htm.cpp
+#include "htm.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if HTM_X86
+#include <cpuid.h>
+#endif
+
+namespace htm {
+
+namespace {
+
+#if HTM_X86
+bool cpuHasRTM() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return (ebx & (1u << 11)) != 0;
+}
+
+// Only called once cpuHasRTM() said _xbegin is a valid instruction
+bool probeCommits() {
+    for (int attempt = 0; attempt < 64; attempt++) {
+        if (_xbegin() == _XBEGIN_STARTED) {
+            _xend();
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+Support detect() {
+    Support s;
+    const char* env = std::getenv("HTM_DISABLE");
+    s.disabled_by_env = env && *env && std::strcmp(env, "0") != 0;
+
+#if HTM_X86
+    s.cpu_has_rtm = cpuHasRTM();
+    if (s.cpu_has_rtm && !s.disabled_by_env) {
+        s.probe_committed = probeCommits();
+    }
+#endif
+
+    s.enabled = s.probe_committed;
+    if (s.enabled) {
+        s.description = "hardware (Intel RTM) with fallback lock";
+    } else if (s.disabled_by_env) {
+        s.description = "fallback lock only (HTM_DISABLE set)";
+    } else if (s.cpu_has_rtm) {
+        s.description = "fallback lock only (RTM advertised but every probe transaction aborted)";
+    } else {
+        s.description = "fallback lock only (CPU has no RTM)";
+    }
+    return s;
+}
+
+} // namespace
+
+const Support& support() {
+    static const Support detected = detect();
+    return detected;
+}
+
+} // namespace htm
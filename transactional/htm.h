@@ -0,0 +1,138 @@
+// htm.h
+/**
+ * @brief Hardware transactions with a lock-elision fallback
+ *
+ * Critical sections run as Intel RTM transactions when the CPU advertises RTM
+ * and a probe shows transactions can actually commit; microcode that disables
+ * TSX leaves the CPUID bit set on some parts but aborts every _xbegin. When
+ * hardware transactions are unavailable, or a section keeps aborting, it runs
+ * under a global fallback lock instead. Hardware transactions read that lock
+ * first, so they abort while it is held and the two paths never overlap.
+ *
+ * Setting HTM_DISABLE=1 in the environment forces the fallback path.
+ */
+#ifndef HTM_H
+#define HTM_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "contention_manager.h"
+#include "txn_telemetry.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HTM_X86 1
+#else
+#define HTM_X86 0
+#endif
+
+namespace htm {
+
+// How a critical section was executed
+enum class Path { Hardware, Fallback };
+
+struct Support {
+    bool cpu_has_rtm = false;    // CPUID.(EAX=7,ECX=0):EBX bit 11
+    bool probe_committed = false; // A trivial transaction committed at startup
+    bool disabled_by_env = false; // HTM_DISABLE was set
+    bool enabled = false;         // Hardware path in use
+    const char* description = "";
+};
+
+/**
+ * @brief Detects RTM once per process; later calls return the cached result
+ */
+const Support& support();
+
+// Explicit abort code used when the fallback lock is found held
+constexpr unsigned LOCK_HELD_CODE = 0xff;
+
+#if HTM_X86
+/**
+ * @brief Maps an _xbegin status to the cause the telemetry buckets it under
+ */
+inline AbortCause abortCause(unsigned status) {
+    if ((status & _XABORT_EXPLICIT) && _XABORT_CODE(status) == LOCK_HELD_CODE) {
+        return AbortCause::LockHeld;
+    }
+    if (status & _XABORT_CAPACITY) return AbortCause::Capacity;
+    if (status & _XABORT_CONFLICT) return AbortCause::Conflict;
+    if (status & _XABORT_EXPLICIT) return AbortCause::Explicit;
+    return AbortCause::Other;
+}
+#endif
+
+// Test-and-test-and-set lock that hardware transactions subscribe to
+class FallbackLock {
+public:
+    void lock() {
+        while (true) {
+            while (held.load(std::memory_order_relaxed)) pause();
+            if (!held.exchange(true, std::memory_order_acquire)) return;
+        }
+    }
+    void unlock() { held.store(false, std::memory_order_release); }
+    bool isLocked() const { return held.load(std::memory_order_acquire); }
+
+    static void pause() {
+#if HTM_X86
+        _mm_pause();
+#endif
+    }
+
+private:
+    alignas(64) std::atomic<bool> held{false};
+};
+
+/**
+ * @brief Runs body() atomically with respect to every section guarded by lock
+ *
+ * Tries up to max_attempts hardware transactions, then takes the lock.
+ * Aborts without the retry hint (capacity, unsupported instructions) skip
+ * the remaining attempts. Outcomes go to the calling thread's telemetry
+ * slot, bucketed by the degree of the vertex the section colors. The
+ * contention manager paces the retries and may send the thread straight
+ * to the lock while its abort rate is high.
+ */
+template <typename Body>
+Path execute(FallbackLock& lock, int max_attempts, TxnTelemetry::Thread& telemetry,
+             ContentionManager::Thread& contention, int degree, Body&& body) {
+    int aborts = 0;
+#if HTM_X86
+    if (support().enabled && !contention.preferLock()) {
+        for (int attempt = 0; attempt < max_attempts; attempt++) {
+            // Starting while the lock is held would only abort again
+            while (lock.isLocked()) FallbackLock::pause();
+
+            unsigned status = _xbegin();
+            if (status == _XBEGIN_STARTED) {
+                if (lock.isLocked()) _xabort(LOCK_HELD_CODE);
+                body();
+                _xend();
+                telemetry.recordCommit(degree);
+                contention.finished(aborts, degree);
+                return Path::Hardware;
+            }
+
+            AbortCause cause = abortCause(status);
+            telemetry.recordAbort(cause, degree);
+            aborts++;
+            if (!(status & _XABORT_RETRY) && cause != AbortCause::LockHeld) break;
+
+            // A hardware attempt reads about one word per neighbor
+            contention.backoff(aborts, static_cast<uint64_t>(degree) * aborts, &telemetry);
+        }
+    }
+#endif
+    lock.lock();
+    body();
+    lock.unlock();
+    telemetry.recordFallback(degree);
+    contention.finished(aborts, degree);
+    return Path::Fallback;
+}
+
+} // namespace htm
+
+#endif // HTM_H
@@ -0,0 +1,23 @@
+// htm_coloring.cpp
+#include "htm_coloring.h"
+
+class HTMColorGraph : public ColorGraph {
+private:
+    int num_threads;
+
+public:
+    explicit HTMColorGraph(int threads) : num_threads(threads) {}
+
+    void colorGraph(const CSRGraph &graph, std::vector<color> &colors) override {
+        int threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+        std::cout << "Transactional path: " << htm::support().description << std::endl;
+
+        OptimizedTSXGraphColoring tsx_coloring(graph, threads);
+        colors = tsx_coloring.colorGraph();
+        tsx_coloring.transactionTelemetry().dumpIfRequested();
+    }
+};
+
+std::unique_ptr<ColorGraph> createHTMColorGraph(int num_threads) {
+    return std::make_unique<HTMColorGraph>(num_threads);
+}
@@ -0,0 +1,381 @@
+// htm_coloring.h
+#ifndef HTM_COLORING_H
+#define HTM_COLORING_H
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <omp.h>
+#include <atomic>
+#include "color_graph.h"
+#include "coloring_order.h"
+#include "contention_manager.h"
+#include "csr_graph.h"
+#include "forbidden_colors.h"
+#include "htm.h"
+#include "phase_timer.h"
+#include "txn_telemetry.h"
+
+// Constants for the HTM implementation
+constexpr int MAX_RETRIES = 8;
+constexpr int MAX_RESOLUTION_ITERATIONS = 3;
+constexpr int MIN_COLORS_BUFFER = 16; // Extra buffer for color vectors
+constexpr int CONTENTION_THRESHOLD = 4; // Threshold for identifying high contention vertices
+constexpr int HIGH_DEGREE_MIN_THRESHOLD = 50; // Minimum high degree threshold
+constexpr int PREFETCH_DISTANCE = 8;  // Prefetch distance for cache optimization
+constexpr int FALLBACK_THRESHOLD = 3; // Consecutive abort threshold to trigger fallback
+constexpr int VECTOR_BATCH_SIZE = 4;  // Size for vector coloring batch operations
+
+struct VertexInfo {
+    int color;
+    int degree;
+    bool processing_flag;
+    char padding[5]; // Pad to 16 bytes for cache alignment
+};
+
+class OptimizedTSXGraphColoring {
+    private:
+        const CSRGraph& graph;
+        int num_threads;
+        int num_vertices;
+        std::vector<int> colors;
+        std::vector<int> vertex_degrees;
+        std::vector<int> ordered_vertices;
+        std::atomic<int> max_color;
+        std::vector<std::atomic<bool>> conflict_flags;
+        std::vector<int> conflict_count;
+        // Serializes fallback sections; RTM transactions subscribe to it
+        htm::FallbackLock fallback_lock;
+        TxnTelemetry telemetry;
+        ContentionManager contention;
+        
+        // Fast vertex preparation with binning
+        void prepareVertices() {
+            PhaseTimer::Scope phase(Phase::Ordering);
+            vertex_degrees.resize(num_vertices);
+            ordered_vertices.resize(num_vertices);
+            
+            // Calculate degree for each vertex
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < num_vertices; i++) {
+                vertex_degrees[i] = graph.neighbors(i).size();
+                ordered_vertices[i] = i;
+            }
+            
+            // A preset order has already been applied to the vertex ids
+            if (PresetColoringOrder::active()) return;
+
+            // Use binning approach for large graphs
+            if (num_vertices > 10000) {
+                // Find max degree for binning
+                int max_degree = 0;
+                for (int d : vertex_degrees) {
+                    max_degree = std::max(max_degree, d);
+                }
+                
+                // Create degree bins (using vector of vectors is faster than priority queue for large data)
+                std::vector<std::vector<int>> degree_bins(max_degree + 1);
+                for (int i = 0; i < num_vertices; i++) {
+                    degree_bins[vertex_degrees[i]].push_back(i);
+                }
+                
+                // Flatten bins to ordered_vertices (highest degree first)
+                int idx = 0;
+                for (int d = max_degree; d >= 0; d--) {
+                    for (int v : degree_bins[d]) {
+                        ordered_vertices[idx++] = v;
+                    }
+                }
+            } else {
+                // For smaller graphs, direct sort is fine
+                std::sort(ordered_vertices.begin(), ordered_vertices.end(),
+                         [this](int a, int b) {
+                             return vertex_degrees[a] > vertex_degrees[b] || 
+                                    (vertex_degrees[a] == vertex_degrees[b] && a < b);
+                         });
+            }
+        }
+        
+        // Optimized minimum color finder using the per-thread forbidden bitset
+        int findMinAvailableColor(int vertex, int current_max_color) {
+            ForbiddenColors& forbidden = ForbiddenColors::local();
+            forbidden.clear();
+            
+            // Colors this far above the current maximum cannot be the minimum
+            const int buffer_size = current_max_color + 16;
+            
+            // Mark colors used by neighbors
+            const auto& neighbors = graph.neighbors(vertex);
+            for (int neighbor : neighbors) {
+                int neighbor_color = colors[neighbor];
+                if (neighbor_color < buffer_size) {
+                    forbidden.forbid(neighbor_color);
+                }
+            }
+            
+            // Find first available color
+            int color = forbidden.firstAvailable();
+            return color < buffer_size ? color : current_max_color;
+        }
+        
+        // Pre-compute color outside transaction to reduce transaction size
+        inline int precomputeColor(int vertex) {
+            int current_max = max_color.load(std::memory_order_relaxed);
+            return findMinAvailableColor(vertex, current_max);
+        }
+        
+        // Check if vertex is likely to have high contention
+        inline bool isHighContentionVertex(int vertex) {
+            // Observed retry rate of this degree range once known, degree > 100 until then
+            return contention.isHotDegree(vertex_degrees[vertex], vertex_degrees[vertex] > 100);
+        }
+        
+        // Colors a vertex and raises max_color if needed; callers make it atomic
+        void assignMinColor(int vertex) {
+            int current_max = max_color.load(std::memory_order_relaxed);
+            int min_color = findMinAvailableColor(vertex, current_max);
+            
+            if (min_color >= current_max) {
+                max_color.store(min_color + 1, std::memory_order_relaxed);
+            }
+            
+            colors[vertex] = min_color;
+        }
+        
+        // Handle high contention vertices without transactions
+        void colorHighContentionVertex(int vertex) {
+            fallback_lock.lock();
+            assignMinColor(vertex);
+            fallback_lock.unlock();
+            telemetry.thread(omp_get_thread_num()).recordFallback(vertex_degrees[vertex]);
+        }
+        
+    public:
+        OptimizedTSXGraphColoring(const CSRGraph& g, int threads) 
+            : graph(g), 
+              num_threads(threads), 
+              num_vertices(g.numVertices()),
+              colors(g.numVertices(), -1),
+              conflict_flags(g.numVertices()),
+              conflict_count(g.numVertices(), 0),
+              max_color(0),
+              telemetry("htm", std::max(threads, omp_get_max_threads())),
+              contention(contentionPolicyFromEnv(), std::max(threads, omp_get_max_threads()))
+        {
+            prepareVertices();
+        }
+        
+        std::vector<int> colorGraph() {
+            // Adjust thread count based on graph size
+            int optimal_threads = num_threads;
+            if (num_vertices < 1000) {
+                optimal_threads = std::min(num_threads, 2); // Use fewer threads for small graphs
+            } else if (num_vertices > 10000 && vertex_degrees[ordered_vertices[0]] > 1000) {
+                // For very dense graphs, reduce threads to avoid contention
+                optimal_threads = std::max(1, num_threads / 2);
+            }
+            
+            omp_set_num_threads(optimal_threads);
+            std::cout << "Using " << optimal_threads << " threads for optimized TSX coloring" << std::endl;
+            
+            // First phase: color high-degree vertices sequentially to reduce conflicts
+            const int high_degree_threshold = std::max(50, num_vertices / 100);
+            int current_max = 0;
+            int high_degree_count = 0;
+            
+            {
+                PhaseTimer::Scope phase(Phase::Precolor);
+                for (int i = 0; i < num_vertices && vertex_degrees[ordered_vertices[i]] > high_degree_threshold; i++) {
+                    int vertex = ordered_vertices[i];
+                    colors[vertex] = findMinAvailableColor(vertex, current_max);
+                    current_max = std::max(current_max, colors[vertex] + 1);
+                    high_degree_count++;
+                }
+            }
+            
+            max_color.store(current_max);
+            
+            std::cout << "Pre-colored " << high_degree_count << " high-degree vertices using " 
+                      << current_max << " colors" << std::endl;
+            
+            // Set dynamic chunk size for better load balancing
+            const int chunk_size = std::max(32, num_vertices / (optimal_threads * 16));
+            
+            // Second phase: parallel coloring with optimized HTM
+            {
+                PhaseTimer::Scope phase(Phase::Color);
+                #pragma omp parallel for schedule(dynamic, chunk_size)
+                for (int i = high_degree_count; i < num_vertices; i++) {
+                    int vertex = ordered_vertices[i];
+                
+                    // Skip already colored vertices
+                    if (colors[vertex] != -1) continue;
+                
+                    // For high-contention vertices, use non-transactional approach
+                    if (isHighContentionVertex(vertex)) {
+                        colorHighContentionVertex(vertex);
+                        continue;
+                    }
+                
+                    // Pre-compute color outside transaction
+                    int precomputed_color = precomputeColor(vertex);
+                
+                    // if color doesn't increase max, just assign it
+                    int current_max = max_color.load(std::memory_order_relaxed);
+                    if (precomputed_color < current_max) {
+                        colors[vertex] = precomputed_color;
+                        continue;
+                    }
+                
+                    // RTM transaction with a few retries, then the fallback lock
+                    const int MAX_RETRIES = 4;
+                    const int thread_id = omp_get_thread_num();
+                    htm::execute(fallback_lock, MAX_RETRIES, telemetry.thread(thread_id),
+                                 contention.thread(thread_id), vertex_degrees[vertex],
+                                 [&]() { assignMinColor(vertex); });
+                }
+            }
+            
+            // Report transaction statistics
+            TxnTelemetry::Thread totals = telemetry.totals();
+            std::cout << "Transaction statistics: " 
+                      << totals.commits << " successful, "
+                      << totals.totalAborts() << " aborted, "
+                      << totals.fallbacks << " fallback lock executions" << std::endl;
+            telemetry.printSummary(std::cout);
+            contention.printSummary(std::cout);
+            
+            // Third phase: conflict detection and resolution 
+            const int MAX_RESOLUTION_ITERATIONS = 2;
+            bool has_conflicts = true;
+            int resolution_iterations = 0;
+            
+            while (has_conflicts && resolution_iterations < MAX_RESOLUTION_ITERATIONS) {
+                has_conflicts = false;
+                
+                int conflict_vertices = 0;
+                {
+                    PhaseTimer::Scope phase(Phase::ConflictDetection);
+                    // Reset conflict flags
+                    #pragma omp parallel for
+                    for (int i = 0; i < num_vertices; i++) {
+                        conflict_flags[i].store(false, std::memory_order_relaxed);
+                    }
+                
+                    // Detect conflicts in parallel
+                    #pragma omp parallel
+                    {
+                        bool local_conflicts = false;
+                    
+                        #pragma omp for schedule(dynamic, chunk_size)
+                        for (int i = 0; i < num_vertices; i++) {
+                            int vertex = i;
+                            int color_i = colors[vertex];
+                        
+                            const auto& neighbors = graph.neighbors(vertex);
+                            for (int neighbor : neighbors) {
+                                if (neighbor < vertex) continue; // Check each edge only once
+                            
+                                if (color_i == colors[neighbor]) {
+                                    // Determine which vertex to recolor based on degree
+                                    if (vertex_degrees[vertex] <= vertex_degrees[neighbor]) {
+                                        conflict_flags[vertex].store(true, std::memory_order_relaxed);
+                                    } else {
+                                        conflict_flags[neighbor].store(true, std::memory_order_relaxed);
+                                    }
+                                
+                                    local_conflicts = true;
+                                }
+                            }
+                        }
+                    
+                        // Combine thread-local conflict indicators
+                        if (local_conflicts) {
+                            #pragma omp atomic write
+                            has_conflicts = true;
+                        }
+                    }
+                
+                    // Count conflict vertices
+                    #pragma omp parallel for reduction(+:conflict_vertices)
+                    for (int i = 0; i < num_vertices; i++) {
+                        if (conflict_flags[i].load(std::memory_order_relaxed)) {
+                            conflict_vertices++;
+                        }
+                    }
+                }
+
+                if (has_conflicts) {
+                    PhaseTimer::Scope phase(Phase::ConflictResolution);
+                    std::cout << "Iteration " << resolution_iterations + 1 
+                              << ": Found " << conflict_vertices << " conflicts" << std::endl;
+                    
+                    // Resolve conflicts
+                    #pragma omp parallel for schedule(dynamic, 1)
+                    for (int vertex = 0; vertex < num_vertices; vertex++) {
+                        if (conflict_flags[vertex].load(std::memory_order_relaxed)) {
+                            // Just assign a unique color to avoid further conflicts
+                            int new_color = max_color.fetch_add(1, std::memory_order_relaxed);
+                            colors[vertex] = new_color;
+                            conflict_flags[vertex].store(false, std::memory_order_relaxed);
+                        }
+                    }
+                }
+                
+                resolution_iterations++;
+            }
+            
+            return colors;
+        }        
+        // Per-cause, per-degree and per-thread transaction counters
+        const TxnTelemetry& transactionTelemetry() const { return telemetry; }
+        
+        // Get statistics about the coloring process
+        void printColoringStats() const {
+            // Calculate transaction success rate
+            TxnTelemetry::Thread totals = telemetry.totals();
+            uint64_t commits = totals.commits;
+            uint64_t total_txn = commits + totals.totalAborts();
+            float success_rate = (float)commits / (total_txn > 0 ? total_txn : 1) * 100.0f;
+            
+            std::cout << "TSX Transaction Statistics:" << std::endl;
+            std::cout << "  Execution path: " << htm::support().description << std::endl;
+            std::cout << "  Success rate: " << success_rate << "%" << std::endl;
+            std::cout << "  Fallback lock executions: " << totals.fallbacks << std::endl;
+            
+            // Calculate color frequency
+            std::vector<int> color_counts;
+            int max_c = *std::max_element(colors.begin(), colors.end()) + 1;
+            color_counts.resize(max_c, 0);
+            
+            for (int color : colors) {
+                color_counts[color]++;
+            }
+            
+            std::cout << "Color distribution: ";
+            int top_colors = std::min(5, max_c);
+            for (int i = 0; i < top_colors; i++) {
+                std::cout << "Color " << i << ": " << color_counts[i] << " vertices, ";
+            }
+            std::cout << "..." << std::endl;
+            
+            // Print conflict stats
+            int conflicts_total = 0;
+            int max_conflicts = 0;
+            for (int count : conflict_count) {
+                conflicts_total += count;
+                max_conflicts = std::max(max_conflicts, count);
+            }
+            
+            std::cout << "Conflict resolution stats: " 
+                      << conflicts_total << " total conflicts, "
+                      << max_conflicts << " max conflicts per vertex" << std::endl;
+        }
+    };
+
+// ColorGraph adapter so the engine can run next to the others in one driver;
+// num_threads <= 0 uses omp_get_max_threads()
+std::unique_ptr<ColorGraph> createHTMColorGraph(int num_threads = 0);
+
+#endif // HTM_COLORING_H
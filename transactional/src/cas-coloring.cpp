@@ -0,0 +1,101 @@
+#include "forbidden_colors.h"
+#include "graph.h"
+#include "phase_timer.h"
+#include <atomic>
+#include <vector>
+#include <omp.h>
+
+// Lock-free baseline for the transactional engines: every vertex publishes its
+// color with one compare-and-swap and then rechecks its neighbors, with no
+// global lock, no max_color and no STM. A vertex that finds a smaller-id
+// neighbor with its color picks again on the spot; the few conflicts both
+// sides miss are caught by a conflict pass after a barrier, and only the
+// losers (larger id) are colored again in the next round.
+class CASColorGraph : public ColorGraph {
+private:
+    // In-place retries before a vertex is left to the conflict pass
+    static constexpr int MAX_RECHECKS = 8;
+
+    static bool hasSmallerConflict(const CSRGraph &graph,
+                                   const std::vector<std::atomic<color>> &vertex_colors,
+                                   int u, color c) {
+        for (const auto &v : graph.neighbors(u)) {
+            if (v < u && vertex_colors[v].load(std::memory_order_seq_cst) == c) return true;
+        }
+        return false;
+    }
+
+public:
+    void colorGraph(const CSRGraph &graph,
+                   std::vector<color> &colors) override {
+        const int numNodes = graph.numVertices();
+        std::vector<std::atomic<color>> vertex_colors(numNodes);
+        std::vector<int> worklist(numNodes);
+        std::vector<char> lost(numNodes, 0);
+        int worklist_size = numNodes;
+
+        {
+            PhaseTimer::Scope phase(Phase::Setup);
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < numNodes; i++) {
+                vertex_colors[i].store(-1, std::memory_order_relaxed);
+                worklist[i] = i;
+            }
+        }
+
+        while (worklist_size > 0) {
+            // Color the worklist; each vertex is owned by one thread in a round
+            {
+                PhaseTimer::Scope phase(Phase::Color);
+                #pragma omp parallel for schedule(dynamic, 64)
+                for (int index = 0; index < worklist_size; index++) {
+                    const int u = worklist[index];
+                    ForbiddenColors &forbidden = ForbiddenColors::local();
+
+                    for (int attempt = 0; attempt < MAX_RECHECKS; attempt++) {
+                        forbidden.clear();
+                        for (const auto &v : graph.neighbors(u)) {
+                            if (v != u) forbidden.forbid(vertex_colors[v].load(std::memory_order_relaxed));
+                        }
+                        color selected = forbidden.firstAvailable();
+
+                        // The seq_cst CAS orders the publish before the recheck loads, so
+                        // of two neighbors that publish the same color at least one sees it
+                        color expected = vertex_colors[u].load(std::memory_order_relaxed);
+                        if (!vertex_colors[u].compare_exchange_strong(expected, selected,
+                                                                      std::memory_order_seq_cst)) {
+                            continue;
+                        }
+                        if (!hasSmallerConflict(graph, vertex_colors, u, selected)) break;
+                    }
+                }
+            }
+
+            // Conflict pass: of two equal neighbors the larger id colors again
+            PhaseTimer::Scope phase(Phase::ConflictDetection);
+            #pragma omp parallel for schedule(dynamic, 256)
+            for (int index = 0; index < worklist_size; index++) {
+                const int u = worklist[index];
+                lost[index] = hasSmallerConflict(graph, vertex_colors, u,
+                                                 vertex_colors[u].load(std::memory_order_relaxed));
+            }
+
+            int next_size = 0;
+            for (int index = 0; index < worklist_size; index++) {
+                if (lost[index]) worklist[next_size++] = worklist[index];
+            }
+            worklist_size = next_size;
+        }
+
+        colors.resize(numNodes);
+        PhaseTimer::Scope phase(Phase::Output);
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < numNodes; i++) {
+            colors[i] = vertex_colors[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+std::unique_ptr<ColorGraph> createCASColorGraph() {
+    return std::make_unique<CASColorGraph>();
+}
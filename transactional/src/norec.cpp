@@ -0,0 +1,76 @@
+#include "norec.h"
+
+#include "csr_graph.h"
+
+namespace norec {
+
+namespace {
+
+// Even when no writer is committing
+alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> sequence_lock{0};
+
+} // namespace
+
+Transaction &Transaction::local() {
+    static thread_local Transaction instance;
+    return instance;
+}
+
+uint64_t Transaction::load(const LogEntry &entry) {
+    if (entry.size == sizeof(uint32_t)) {
+        return __atomic_load_n(static_cast<const uint32_t *>(entry.addr), __ATOMIC_ACQUIRE);
+    }
+    return __atomic_load_n(static_cast<const uint64_t *>(entry.addr), __ATOMIC_ACQUIRE);
+}
+
+bool Transaction::sequenceChanged() const {
+    return sequence_lock.load(std::memory_order_acquire) != snapshot;
+}
+
+void Transaction::begin() {
+    read_set.clear();
+    write_set.clear();
+    do {
+        snapshot = sequence_lock.load(std::memory_order_acquire);
+    } while (snapshot & 1);
+}
+
+uint64_t Transaction::validate() {
+    while (true) {
+        uint64_t sequence = sequence_lock.load(std::memory_order_acquire);
+        if (sequence & 1) continue;
+
+        for (const LogEntry &entry : read_set) {
+            if (load(entry) != entry.value) throw Abort{AbortCause::Conflict};
+        }
+        if (sequence_lock.load(std::memory_order_acquire) == sequence) {
+            return sequence;
+        }
+    }
+}
+
+void Transaction::commit() {
+    if (write_set.empty()) {
+        // The read log was consistent at the last snapshot
+        return;
+    }
+
+    // Take the sequence lock at a snapshot our reads are still valid for
+    while (!sequence_lock.compare_exchange_weak(snapshot, snapshot + 1, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+        snapshot = validate();
+    }
+
+    for (const LogEntry &entry : write_set) {
+        if (entry.size == sizeof(uint32_t)) {
+            __atomic_store_n(static_cast<uint32_t *>(entry.addr),
+                             static_cast<uint32_t>(entry.value), __ATOMIC_RELAXED);
+        } else {
+            __atomic_store_n(static_cast<uint64_t *>(entry.addr), entry.value, __ATOMIC_RELAXED);
+        }
+    }
+
+    sequence_lock.store(snapshot + 2, std::memory_order_release);
+}
+
+} // namespace norec
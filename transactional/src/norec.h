@@ -0,0 +1,143 @@
+/**
+ * @file norec.h
+ * @brief NOrec software transactional memory
+ *
+ * NOrec (Dalessandro, Spear and Scott, PPoPP 2010) keeps no per-location
+ * metadata. A single global sequence lock is odd while a writer commits.
+ * Reads log the value they saw; when the sequence lock has moved since the
+ * last check, the whole log is revalidated by value. Writers serialize on the
+ * sequence lock only for the write-back of their redo log.
+ *
+ * A coloring transaction writes one color, so commits are short and the
+ * global lock is held only for a single store; reads cost one load of the
+ * sequence lock instead of a lock-table lookup.
+ */
+
+#ifndef NOREC_H
+#define NOREC_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "contention_manager.h"
+#include "txn_telemetry.h"
+
+namespace norec {
+
+// Thrown by read() and commit() when a logged value changed underneath us
+struct Abort {
+    AbortCause cause;
+};
+
+class Transaction {
+public:
+    /**
+     * @brief Transaction descriptor owned by the calling thread
+     */
+    static Transaction &local();
+
+    void begin();
+
+    /**
+     * @brief Transactional load of a 4- or 8-byte word
+     */
+    template <typename T>
+    T read(const T *addr) {
+        static_assert(std::is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                      "NOrec words are 4- or 8-byte integers");
+        for (const LogEntry &entry : write_set) {
+            if (entry.addr == addr) return static_cast<T>(entry.value);
+        }
+
+        T value = __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+        // A commit since our snapshot may have changed what we already read
+        while (sequenceChanged()) {
+            snapshot = validate();
+            value = __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+        }
+        read_set.push_back({const_cast<T *>(addr), static_cast<uint64_t>(value), sizeof(T)});
+        return value;
+    }
+
+    /**
+     * @brief Buffers a store until commit
+     */
+    template <typename T>
+    void write(T *addr, T value) {
+        static_assert(std::is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                      "NOrec words are 4- or 8-byte integers");
+        for (LogEntry &entry : write_set) {
+            if (entry.addr == addr) {
+                entry.value = static_cast<uint64_t>(value);
+                return;
+            }
+        }
+        write_set.push_back({addr, static_cast<uint64_t>(value), sizeof(T)});
+    }
+
+    /**
+     * @brief Publishes the redo log; throws Abort if a logged read went stale
+     */
+    void commit();
+
+    /**
+     * @brief Runs body(tx) until it commits, backing off between attempts
+     *
+     * Commits, aborts by cause and backoff time go to telemetry if given,
+     * bucketed by the degree of the vertex the transaction colors. With a
+     * contention manager the waits follow its policy and the outcome feeds
+     * its abort-rate estimate; otherwise plain randomized backoff is used.
+     */
+    template <typename Body>
+    void atomically(Body &&body, TxnTelemetry::Thread *telemetry = nullptr, int degree = 0,
+                    ContentionManager::Thread *contention = nullptr) {
+        int attempt = 0;
+        uint64_t karma = 0;
+        while (true) {
+            begin();
+            try {
+                body(*this);
+                commit();
+                if (telemetry) telemetry->recordCommit(degree);
+                if (contention) contention->finished(attempt, degree);
+                return;
+            } catch (const Abort &abort) {
+                if (telemetry) telemetry->recordAbort(abort.cause, degree);
+                karma += read_set.size();
+                attempt++;
+                if (contention) {
+                    contention->backoff(attempt, karma, telemetry);
+                } else {
+                    backoff.pause(attempt);
+                }
+            }
+        }
+    }
+
+private:
+    struct LogEntry {
+        void *addr;
+        uint64_t value;
+        unsigned size;
+    };
+
+    static uint64_t load(const LogEntry &entry);
+    bool sequenceChanged() const;
+
+    /**
+     * @brief Waits for a quiescent sequence lock and rechecks every logged read
+     * @return The sequence value the read log is consistent with
+     */
+    uint64_t validate();
+
+    uint64_t snapshot = 0;
+    std::vector<LogEntry> read_set;
+    std::vector<LogEntry> write_set;
+    RandomizedBackoff backoff;
+};
+
+} // namespace norec
+
+#endif // NOREC_H
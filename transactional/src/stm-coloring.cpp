@@ -1,4 +1,8 @@
 #include "stm-coloring.h"
+#include "coloring_order.h"
+#include "forbidden_colors.h"
+#include "phase_timer.h"
+#include "tl2.h"
 #include <algorithm>
 #include <string.h>
 #include <mutex>
@@ -11,14 +15,10 @@
 #include <atomic>
 #include <unordered_map>
 #include <random>
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <fstream>
-#include <sstream>
-#include <unistd.h>
 #include <chrono>
 #include <iomanip>
+#include <array>
+#include <numeric>
 
 // Thread timing data structure
 struct ThreadTiming {
@@ -88,218 +88,6 @@ void printThreadTimings(const std::vector<ThreadTiming>& timings) {
 typedef int graphNode;
 typedef int color;
 
-// Constants
-constexpr size_t READ_BUFFER_SIZE = 1024 * 1024; // 1MB buffer for file reading
-
-// Thread-local storage with custom pool to reduce allocation/deallocation overhead
-class TLSColorPool {
-private:
-    static constexpr size_t POOL_SIZE = 16; // Number of pools per thread
-    struct Pool {
-        bool* forbidden_colors;
-        size_t size;
-        bool in_use;
-        
-        Pool() : forbidden_colors(nullptr), size(0), in_use(false) {}
-        ~Pool() {
-            if (forbidden_colors != nullptr) {
-                free(forbidden_colors);
-                forbidden_colors = nullptr;
-            }
-        }
-    };
-    
-    // Array of pools
-    std::array<Pool, POOL_SIZE> pools;
-    bool initialized;
-    
-public:
-    TLSColorPool() : initialized(false) {}
-    
-    ~TLSColorPool() {
-    }
-    
-    void initialize() {
-        if (!initialized) {
-            for (size_t i = 0; i < POOL_SIZE; i++) {
-                pools[i].forbidden_colors = nullptr;
-                pools[i].size = 0;
-                pools[i].in_use = false;
-            }
-            initialized = true;
-        }
-    }
-    
-    bool* acquire(size_t size) {
-        if (!initialized) initialize();
-        
-        // Find an available pool with sufficient size
-        for (size_t i = 0; i < POOL_SIZE; i++) {
-            if (!pools[i].in_use) {
-                if (pools[i].forbidden_colors == nullptr || pools[i].size < size) {
-                    // Allocate or resize
-                    if (pools[i].forbidden_colors != nullptr) {
-                        free(pools[i].forbidden_colors);
-                    }
-                    
-                    // Align allocation to cache line
-                    void* ptr = nullptr;
-                    if (posix_memalign(&ptr, 64, size * sizeof(bool)) != 0) {
-                        std::cerr << "Memory allocation failed" << std::endl;
-                        exit(1);
-                    }
-                    
-                    pools[i].forbidden_colors = static_cast<bool*>(ptr);
-                    pools[i].size = size;
-                }
-                
-                pools[i].in_use = true;
-                memset(pools[i].forbidden_colors, 0, size * sizeof(bool));
-                return pools[i].forbidden_colors;
-            }
-        }
-        
-        // If all pools are in use, allocate a new temporary buffer
-        void* ptr = nullptr;
-        if (posix_memalign(&ptr, 64, size * sizeof(bool)) != 0) {
-            std::cerr << "Memory allocation failed" << std::endl;
-            exit(1);
-        }
-        bool* tmp = static_cast<bool*>(ptr);
-        memset(tmp, 0, size * sizeof(bool));
-        return tmp;
-    }
-    
-    void release(bool* buffer) {
-        if (!initialized) return;
-        
-        // Check if buffer belongs to any pool
-        for (size_t i = 0; i < POOL_SIZE; i++) {
-            if (pools[i].forbidden_colors == buffer) {
-                pools[i].in_use = false;
-                return;
-            }
-        }
-        
-        // If not found in pool, it was a temporary allocation
-        free(buffer);
-    }
-};
-
-// Thread-local storage for color arrays
-thread_local TLSColorPool tls_color_pool;
-
-// Better memory-mapped file reading
-graphNode readGraphFromFile(const std::string& filename,
-                         std::vector<graphNode>& nodes,
-                         std::vector<std::pair<graphNode, graphNode>>& edges) {
-    nodes.clear();
-    edges.clear();
-    
-    // Use memory-mapped IO for large files
-    struct stat sb;
-    if (stat(filename.c_str(), &sb) == -1) {
-        std::cerr << "Error: Cannot stat file " << filename << std::endl;
-        return -1;
-    }
-    
-    if (sb.st_size > 100 * 1024 * 1024) { // Use mmap for files > 100MB
-        int fd = open(filename.c_str(), O_RDONLY);
-        if (fd == -1) {
-            std::cerr << "Error: Cannot open file " << filename << std::endl;
-            return -1;
-        }
-        
-        void* mapped = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-        if (mapped == MAP_FAILED) {
-            close(fd);
-            std::cerr << "Error: Cannot mmap file " << filename << std::endl;
-            return -1;
-        }
-        
-        const char* fileContent = static_cast<const char*>(mapped);
-        const char* end = fileContent + sb.st_size;
-        const char* lineStart = fileContent;
-        
-        // Pre-allocate based on file size estimate
-        size_t estLines = sb.st_size / 20; // Rough estimate
-        nodes.reserve(estLines / 3);
-        edges.reserve(estLines * 2 / 3);
-        
-        graphNode maxNode = 0;
-        
-        while (lineStart < end) {
-            const char* lineEnd = lineStart;
-            while (lineEnd < end && *lineEnd != '\n') lineEnd++;
-            
-            std::string line(lineStart, lineEnd);
-            if (!line.empty() && line[0] != '#') {
-                std::istringstream iss(line);
-                graphNode n1, n2;
-                if (iss >> n1 >> n2) {
-                    nodes.push_back(n1);
-                    nodes.push_back(n2);
-                    edges.emplace_back(n1, n2);
-                    maxNode = std::max(maxNode, std::max(n1, n2));
-                }
-            }
-            
-            lineStart = lineEnd + 1;
-            if (lineStart >= end) break;
-        }
-        
-        // Sort and remove duplicates from nodes
-        std::sort(nodes.begin(), nodes.end());
-        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
-        
-        munmap(mapped, sb.st_size);
-        close(fd);
-        
-        return maxNode;
-    } else {
-        // For smaller files, use buffered IO
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "Error: Cannot open file " << filename << std::endl;
-            return -1;
-        }
-        
-        // Pre-allocate vectors based on file size
-        size_t estLines = sb.st_size / 20;
-        nodes.reserve(estLines / 3);
-        edges.reserve(estLines * 2 / 3);
-        
-        graphNode maxNode = 0;
-        std::vector<graphNode> nodeSet; // To track unique nodes
-        nodeSet.reserve(estLines / 2);
-        
-        char buffer[READ_BUFFER_SIZE];
-        std::string line;
-        
-        while (file.getline(buffer, READ_BUFFER_SIZE)) {
-            line = buffer;
-            if (!line.empty() && line[0] != '#') {
-                std::istringstream iss(line);
-                graphNode n1, n2;
-                if (iss >> n1 >> n2) {
-                    nodeSet.push_back(n1);
-                    nodeSet.push_back(n2);
-                    edges.emplace_back(n1, n2);
-                    maxNode = std::max(maxNode, std::max(n1, n2));
-                }
-            }
-        }
-        
-        // Sort and remove duplicates from nodes
-        std::sort(nodeSet.begin(), nodeSet.end());
-        nodes.resize(std::unique(nodeSet.begin(), nodeSet.end()) - nodeSet.begin());
-        std::copy(nodeSet.begin(), nodeSet.begin() + nodes.size(), nodes.begin());
-        
-        file.close();
-        return maxNode;
-    }
-}
-
 // Custom hash table for better performance on graph operations
 template<typename Key, typename Value>
 class FastHashMap {
@@ -440,30 +228,28 @@ private:
 };
 
 // Optimized color finding function
-color findBestColor(size_t node_idx, const std::vector<color>& node_colors, 
+color findBestColor(graphNode node, const std::vector<color>& node_colors, 
                    const std::vector<bool>& colored,
-                   const std::vector<std::vector<size_t>>& neighbor_indices,
+                   const CSRGraph& graph,
                    bool allow_new_colors = false, color current_max = 0) {
     
-    // Get a buffer from the pool
-    bool* forbidden = tls_color_pool.acquire(MAX_COLORS);
+    // Reuse this thread's forbidden set; clearing it is O(1)
+    ForbiddenColors& forbidden = ForbiddenColors::local();
+    forbidden.clear();
     
     // Mark forbidden colors from neighbors
-    const auto& neighbors = neighbor_indices[node_idx];
-    for (size_t nb_idx : neighbors) {
-        if (nb_idx < colored.size() && colored[nb_idx]) {
+    const auto neighbors = graph.neighbors(node);
+    for (graphNode nb_idx : neighbors) {
+        if (colored[nb_idx]) {
             color c = node_colors[nb_idx];
-            if (c >= 0 && c < MAX_COLORS) {
-                forbidden[c] = true;
+            if (c < MAX_COLORS) {
+                forbidden.forbid(c);
             }
         }
     }
     
     // Find first available color
-    color selected = 0;
-    while (selected < MAX_COLORS && forbidden[selected]) {
-        selected++;
-    }
+    color selected = std::min(forbidden.firstAvailable(), MAX_COLORS);
     
     // Handle special cases
     if (selected >= MAX_COLORS && allow_new_colors) {
@@ -473,8 +259,8 @@ color findBestColor(size_t node_idx, const std::vector<color>& node_colors,
         int min_conflicts = std::numeric_limits<int>::max();
         for (color c = 0; c < MAX_COLORS; c++) {
             int conflicts = 0;
-            for (size_t nb_idx : neighbors) {
-                if (nb_idx < colored.size() && colored[nb_idx] && node_colors[nb_idx] == c) {
+            for (graphNode nb_idx : neighbors) {
+                if (colored[nb_idx] && node_colors[nb_idx] == c) {
                     conflicts++;
                 }
             }
@@ -485,9 +271,6 @@ color findBestColor(size_t node_idx, const std::vector<color>& node_colors,
         }
     }
     
-    // Release the buffer back to the pool
-    tls_color_pool.release(forbidden);
-    
     return selected;
 }
 
@@ -496,7 +279,10 @@ LibITMColorGraph::LibITMColorGraph(int iterations, bool try_bipartite, int num_t
     : STMColorGraph(STMType::Libitm, iterations, try_bipartite,num_threads) {}
 
 TL2ColorGraph::TL2ColorGraph(int iterations, bool try_bipartite, int num_threads)
-    : STMColorGraph(STMType::TL2, iterations, try_bipartite, num_threads) {}
+    : WordSTMColorGraph(STMType::TL2, iterations, try_bipartite, num_threads) {}
+
+NOrecColorGraph::NOrecColorGraph(int iterations, bool try_bipartite, int num_threads)
+    : WordSTMColorGraph(STMType::NOrec, iterations, try_bipartite, num_threads) {}
 
 // Constructor with minimal initialization
 STMColorGraph::STMColorGraph(STMType type, int iterations, bool try_bipartite, int num_threads) 
@@ -507,10 +293,7 @@ STMColorGraph::STMColorGraph(STMType type, int iterations, bool try_bipartite, i
       global_max_color(0) {
         
     
-    // Initialize TLS pool
-    tls_color_pool.initialize();
-    
-    const char* type_names[] = {"LibITM", "TL2"};
+    const char* type_names[] = {"LibITM", "TL2", "NOrec"};
     std::cout << "STM Graph Coloring (" << type_names[static_cast<int>(type)] << ")\n";
     std::cout << "Max iterations: " << max_iterations << "\n";
     std::cout << "Bipartite detection: " << (detect_bipartite ? "enabled" : "disabled") << "\n";
@@ -519,97 +302,10 @@ STMColorGraph::STMColorGraph(STMType type, int iterations, bool try_bipartite, i
 STMColorGraph::~STMColorGraph() {
 }
 
-// Optimized graph building with reduced map operations
-void STMColorGraph::buildGraph(
-    std::vector<graphNode> &nodes,
-    std::vector<std::pair<graphNode, graphNode>> &pairs,
-    std::unordered_map<graphNode, std::vector<graphNode>> &graph) {
-    
-    std::cout << "Building graph with optimized algorithm..." << std::endl;
-    
-    // Pre-allocate graph with appropriate capacity to avoid rehashes
-    graph.clear();
-    graph.reserve(nodes.size() * 1.5);  // Reserve with extra headroom
-    
-    // Find max node ID for potential vector-based approach
-    graphNode max_node_id = 0;
-    for (auto node : nodes) {
-        max_node_id = std::max(max_node_id, node);
-    }
-    
-    // Use direct vector indexing if node IDs are dense enough
-    bool use_direct_index = (max_node_id < nodes.size() * 3);
-    std::vector<std::vector<graphNode>> direct_index;
-    
-    if (use_direct_index) {
-        direct_index.resize(max_node_id + 1);
-        for (auto node : nodes) {
-            direct_index[node].reserve(16); // Reserve space for typical adjacency list
-        }
-    } else {
-        // Initialize graph with all nodes
-        for (auto node : nodes) {
-            graph[node]; // Create empty entry for each node
-        }
-    }
-    
-    // Process edges directly
-    for (const auto& edge : pairs) {
-        if (edge.first < 0 || edge.second < 0 || edge.first == edge.second) {
-            continue;
-        }
-        
-        if (use_direct_index) {
-            if (edge.first <= max_node_id && edge.second <= max_node_id) {
-                auto& neighbors1 = direct_index[edge.first];
-                auto& neighbors2 = direct_index[edge.second];
-                
-                // Add edges in both directions if not already present
-                if (std::find(neighbors1.begin(), neighbors1.end(), edge.second) == neighbors1.end()) {
-                    neighbors1.push_back(edge.second);
-                }
-                
-                if (std::find(neighbors2.begin(), neighbors2.end(), edge.first) == neighbors2.end()) {
-                    neighbors2.push_back(edge.first);
-                }
-            }
-        } else {
-            auto& neighbors1 = graph[edge.first];
-            auto& neighbors2 = graph[edge.second];
-            
-            // Add edges in both directions if not already present
-            if (std::find(neighbors1.begin(), neighbors1.end(), edge.second) == neighbors1.end()) {
-                neighbors1.push_back(edge.second);
-            }
-            
-            if (std::find(neighbors2.begin(), neighbors2.end(), edge.first) == neighbors2.end()) {
-                neighbors2.push_back(edge.first);
-            }
-        }
-    }
-    
-    // If we used direct indexing, copy back to the map
-    if (use_direct_index) {
-        for (auto node : nodes) {
-            if (node <= max_node_id) {
-                graph[node] = std::move(direct_index[node]);
-            }
-        }
-    }
-    
-    // Print statistics
-    size_t total_edges = 0;
-    for (const auto& adj_list : graph) {
-        total_edges += adj_list.second.size();
-    }
-    std::cout << "Graph built: " << graph.size() << " nodes, " 
-              << (total_edges / 2) << " edges" << std::endl;
-}
-
 // Optimized STM graph coloring implementation
 void STMColorGraph::colorGraph(
-    std::unordered_map<graphNode, std::vector<graphNode>> &graph,
-    std::unordered_map<graphNode, color> &colors) {
+    const CSRGraph &graph,
+    std::vector<color> &colors) {
     
     // Start timer for performance measurement
     double start_time = omp_get_wtime();
@@ -617,105 +313,37 @@ void STMColorGraph::colorGraph(
     std::cout << "Starting optimized STM coloring..." << std::endl;
     colors.clear();
     
-    if (graph.empty()) {
+    if (graph.numVertices() == 0) {
         std::cout << "Empty graph, nothing to color." << std::endl;
         return;
     }
     
-    // Flat data structures for better cache locality
-    const size_t node_count = graph.size();
+    // Vertex ids are dense, so colors are indexed by id and only the
+    // processing order is permuted
+    const size_t node_count = graph.numVertices();
     std::vector<graphNode> ordered_nodes(node_count);
-    
-    // Pre-calculate node degrees once and find max node ID
-    std::vector<std::pair<graphNode, size_t>> nodes_with_degrees;
-    nodes_with_degrees.reserve(node_count);
-    
-    graphNode max_node_id = 0;
-    size_t idx = 0;
-    for (const auto& entry : graph) {
-        nodes_with_degrees.emplace_back(entry.first, entry.second.size());
-        max_node_id = std::max(max_node_id, entry.first);
-        
-        // Store node in order of iteration for direct access later
-        ordered_nodes[idx++] = entry.first;
-    }
-    
-    // Sort nodes by degree (descending)
-    std::sort(nodes_with_degrees.begin(), nodes_with_degrees.end(),
-        [](const auto& a, const auto& b) {
-            return a.second > b.second;  // Descending by degree
-        });
-    
-    // Extract sorted nodes
-    for (size_t i = 0; i < node_count; i++) {
-        ordered_nodes[i] = nodes_with_degrees[i].first;
-    }
-    
-    // Free memory early
-    nodes_with_degrees.clear();
-    nodes_with_degrees.shrink_to_fit();
-    
-    // Create mapping from node to index - use direct vector if possible
-    std::vector<size_t> node_to_index_vec;
-    std::unordered_map<graphNode, size_t> node_to_index;
-    bool use_direct_index = (max_node_id < node_count * 3);
-    
-    if (use_direct_index) {
-        node_to_index_vec.resize(max_node_id + 1, SIZE_MAX);
-        for (size_t i = 0; i < node_count; i++) {
-            node_to_index_vec[ordered_nodes[i]] = i;
-        }
-    } else {
-        node_to_index.reserve(node_count);
+    {
+        PhaseTimer::Scope phase(Phase::Ordering);
         for (size_t i = 0; i < node_count; i++) {
-            node_to_index[ordered_nodes[i]] = i;
+            ordered_nodes[i] = static_cast<graphNode>(i);
         }
-    }
     
-    // Create adjacency structure with indices for better cache locality
-    std::vector<std::vector<size_t>> neighbor_indices(node_count);
-    
-    // Pre-allocate neighbor vectors based on known degrees
-    for (size_t i = 0; i < node_count; i++) {
-        auto& neighbors = graph[ordered_nodes[i]];
-        neighbor_indices[i].reserve(neighbors.size());
-    }
-    
-    // Fill adjacency structure with indices instead of node IDs
-    for (size_t i = 0; i < node_count; i++) {
-        auto& neighbors = graph[ordered_nodes[i]];
-        auto& indices = neighbor_indices[i];
-        
-        for (graphNode neighbor : neighbors) {
-            size_t neighbor_idx;
-            
-            if (use_direct_index) {
-                if (neighbor <= max_node_id) {
-                    neighbor_idx = node_to_index_vec[neighbor];
-                    if (neighbor_idx != SIZE_MAX) {
-                        indices.push_back(neighbor_idx);
-                    }
-                }
-            } else {
-                auto it = node_to_index.find(neighbor);
-                if (it != node_to_index.end()) {
-                    indices.push_back(it->second);
-                }
-            }
+        // Sort nodes by degree (descending), unless the ids already follow a preset order
+        if (!PresetColoringOrder::active()) {
+            std::stable_sort(ordered_nodes.begin(), ordered_nodes.end(),
+                [&graph](graphNode a, graphNode b) {
+                    return graph.degree(a) > graph.degree(b);  // Descending by degree
+                });
         }
     }
     
-    // Vectors for colors and colored status - aligned for better cache access
-    alignas(64) std::vector<color> node_colors(node_count, -1);
+    // Colors are written straight into the caller's vector, indexed by vertex id
+    std::vector<color>& node_colors = colors;
+    node_colors.assign(node_count, -1);
     alignas(64) std::vector<bool> colored(node_count, false);
     
     // Calculate average degree for adaptive strategies
-    double avg_degree = 0.0;
-    size_t total_edges = 0;
-    for (size_t i = 0; i < node_count; i++) {
-        total_edges += neighbor_indices[i].size();
-    }
-    avg_degree = static_cast<double>(total_edges) / node_count;
+    double avg_degree = static_cast<double>(graph.numAdjacencies()) / node_count;
     std::cout << "Graph density: " << avg_degree << " average degree" << std::endl;
     
     // Configure thread count based on system and graph
@@ -759,14 +387,18 @@ void STMColorGraph::colorGraph(
     std::cout << "Coloring " << seq_nodes << " highest-degree nodes sequentially..." << std::endl;
     
     // Process high-degree nodes sequentially
-    for (size_t i = 0; i < seq_nodes; i++) {
-        color selected = findBestColor(i, node_colors, colored, neighbor_indices);
-        node_colors[i] = selected;
-        colored[i] = true;
-        
-        // Update global max color
-        if (selected > global_max_color) {
-            global_max_color = selected;
+    {
+        PhaseTimer::Scope phase(Phase::Precolor);
+        for (size_t i = 0; i < seq_nodes; i++) {
+            graphNode node = ordered_nodes[i];
+            color selected = findBestColor(node, node_colors, colored, graph);
+            node_colors[node] = selected;
+            colored[node] = true;
+        
+            // Update global max color
+            if (selected > global_max_color) {
+                global_max_color = selected;
+            }
         }
     }
     
@@ -778,6 +410,8 @@ void STMColorGraph::colorGraph(
     
     // Create vector to store thread timing data - must be defined outside the if block
     std::vector<ThreadTiming> thread_timings(active_threads);
+    telemetry.reset(new TxnTelemetry("libitm", active_threads));
+    contention.reset(new ContentionManager(contentionPolicyFromEnv(), active_threads));
     
     if (remaining > 0) {
         std::cout << "Processing remaining " << remaining << " nodes in parallel..." << std::endl;
@@ -792,20 +426,14 @@ void STMColorGraph::colorGraph(
             batch_size = 512;  // Larger batches for sparse graphs
         }
         
-        // Create processing order
-        std::vector<size_t> processing_order;
-        processing_order.reserve(remaining);
-        
-        for (size_t i = seq_nodes; i < node_count; i++) {
-            processing_order.push_back(i);
-        }
-        
         // Process nodes in batches
-        const size_t num_batches = (processing_order.size() + batch_size - 1) / batch_size;
+        const size_t num_batches = (remaining + batch_size - 1) / batch_size;
         std::atomic<size_t> total_retries{0};
         
         #pragma omp parallel
         {
+            PhaseTimer::Scope phase(Phase::Color);
+            
             // Initialize thread-local timing data
             ThreadTiming local_timing;
             int thread_id = omp_get_thread_num();
@@ -816,35 +444,38 @@ void STMColorGraph::colorGraph(
             
             size_t local_retries = 0;
             int thread_max_color = current_max_color;
+            TxnTelemetry::Thread& thread_telemetry = telemetry->thread(thread_id);
+            ContentionManager::Thread& thread_contention = contention->thread(thread_id);
             
             #pragma omp for schedule(dynamic, 1)
             for (size_t batch = 0; batch < num_batches; batch++) {
-                const size_t start_idx = batch * batch_size;
-                const size_t end_idx = std::min(start_idx + batch_size, processing_order.size());
+                const size_t start_idx = seq_nodes + batch * batch_size;
+                const size_t end_idx = std::min(start_idx + batch_size, node_count);
                 
                 // Count nodes for this batch
                 local_timing.nodes_processed += (end_idx - start_idx);
                 
                 for (size_t i = start_idx; i < end_idx; i++) {
-                    size_t node_idx = processing_order[i];
+                    graphNode node_idx = ordered_nodes[i];
                     
                     // Skip if already colored
                     if (colored[node_idx]) continue;
                     
                     // Find best color outside transaction
                     color selected = findBestColor(node_idx, node_colors, colored, 
-                                               neighbor_indices, false, thread_max_color);
+                                               graph, false, thread_max_color);
                     
                     // Try to apply the color with optimistic approach first
+                    const int degree = graph.degree(node_idx);
                     bool success = false;
                     int retry_count = 0;
                     const int MAX_RETRIES = 3;
                     
-                    while (!success && retry_count < MAX_RETRIES) {
+                    while (!success && retry_count < MAX_RETRIES && !thread_contention.preferLock()) {
                         bool conflict = false;
                         
                         // Check for conflicts before transaction to reduce abort rate
-                        for (size_t nb_idx : neighbor_indices[node_idx]) {
+                        for (graphNode nb_idx : graph.neighbors(node_idx)) {
                             if (colored[nb_idx] && node_colors[nb_idx] == selected) {
                                 conflict = true;
                                 break;
@@ -863,21 +494,36 @@ void STMColorGraph::colorGraph(
                         }
                         
                         // If failed, retry with different color
-                        if (!success) {
+                        if (success) {
+                            thread_telemetry.recordCommit(degree);
+                        } else {
+                            // libitm hides its own aborts; count the engine's retries
+                            thread_telemetry.recordAbort(AbortCause::Conflict, degree);
                             retry_count++;
                             local_retries++;
                             local_timing.retries++;  // Track retries in thread timing data
                             
-                            // Find a new color for retry
-                            if (retry_count < MAX_RETRIES) {
-                                selected = findBestColor(node_idx, node_colors, colored, 
-                                                     neighbor_indices, true, thread_max_color);
-                            } else {
-                                // After max retries, use a guaranteed new color
-                                selected = global_max_color.fetch_add(1) + 1;
-                            }
+                            thread_contention.backoff(retry_count,
+                                                      static_cast<uint64_t>(degree) * retry_count,
+                                                      &thread_telemetry);
+                            selected = findBestColor(node_idx, node_colors, colored, 
+                                                 graph, true, thread_max_color);
+                        }
+                    }
+                    
+                    // Retries exhausted or the thread is on the lock path: choose and
+                    // assign the smallest free color irrevocably instead of a fresh one
+                    if (!success) {
+                        __transaction_relaxed {
+                            selected = findBestColor(node_idx, node_colors, colored,
+                                                     graph, true, thread_max_color);
+                            node_colors[node_idx] = selected;
+                            colored[node_idx] = true;
                         }
+                        success = true;
+                        thread_telemetry.recordFallback(degree);
                     }
+                    thread_contention.finished(retry_count, degree);
                     
                     // Update thread local max color
                     if (success && selected > thread_max_color) {
@@ -915,6 +561,8 @@ void STMColorGraph::colorGraph(
         }
         
         // Print thread timing information
+        telemetry->printSummary(std::cout);
+        contention->printSummary(std::cout);
         printThreadTimings(thread_timings);
     }
     
@@ -924,12 +572,13 @@ void STMColorGraph::colorGraph(
     
     #pragma omp parallel
     {
+        PhaseTimer::Scope phase(Phase::ConflictResolution);
         int local_conflicts = 0;
         
         #pragma omp for schedule(dynamic, 128)
         for (size_t i = 0; i < node_count; i++) {
-            for (size_t nb_idx : neighbor_indices[i]) {
-                if (i < nb_idx && node_colors[i] == node_colors[nb_idx]) {
+            for (graphNode nb_idx : graph.neighbors(i)) {
+                if (static_cast<graphNode>(i) < nb_idx && node_colors[i] == node_colors[nb_idx]) {
                     local_conflicts++;
                     
                     // Resolve conflict by assigning a new color
@@ -960,53 +609,181 @@ void STMColorGraph::colorGraph(
     // Final global max color
     int final_max_color = global_max_color.load();
     
-    // Optimize map copying - the primary hotspot for map operations
-    // Use direct copy into pre-allocated map
-    colors.reserve(node_count);
-    if (node_count > 1000) {
-        // Process in chunks to improve cache locality
-        const size_t COPY_CHUNK = 256;
-        
-        #pragma omp parallel
-        {
-            // Thread-local buffer to reduce contention
-            std::vector<std::pair<graphNode, color>> local_buffer;
-            local_buffer.reserve(COPY_CHUNK);
-            
-            #pragma omp for schedule(dynamic, 1)
-            for (size_t chunk_start = 0; chunk_start < node_count; chunk_start += COPY_CHUNK) {
-                size_t chunk_end = std::min(chunk_start + COPY_CHUNK, node_count);
-                local_buffer.clear();
-                
-                // Fill local buffer
-                for (size_t i = chunk_start; i < chunk_end; i++) {
-                    local_buffer.emplace_back(ordered_nodes[i], node_colors[i]);
-                }
-                
-                // Batch insert to minimize lock contention
-                #pragma omp critical
-                {
-                    for (const auto& item : local_buffer) {
-                        colors[item.first] = item.second;
-                    }
-                }
-            }
-        }
-    } else {
-        // Direct copy for smaller graphs
-        for (size_t i = 0; i < node_count; i++) {
-            colors[ordered_nodes[i]] = node_colors[i];
-        }
-    }
-    
     // End timer and report performance
     double end_time = omp_get_wtime();
     double time_spent = end_time - start_time;
     
     std::cout << "Time spent: " << time_spent << " seconds" << std::endl;
     std::cout << "Colored with " << (final_max_color + 1) << " colors" << std::endl;
+    telemetry->dumpIfRequested();
 }
 
+// In-tree STM engines: one transaction per vertex reads the neighbor colors and
+// writes its own, so committed colorings are conflict-free by construction
+template <typename Transaction>
+WordSTMColorGraph<Transaction>::WordSTMColorGraph(STMType type, int iterations,
+                                                  bool try_bipartite, int num_threads)
+    : STMColorGraph(type, iterations, try_bipartite, num_threads) {}
+
+template <typename Transaction>
+void WordSTMColorGraph<Transaction>::optimisticColoring(size_t vertex,
+                                                        const CSRGraph& graph,
+                                                        std::vector<VertexData>& vertex_data) {
+    Transaction& tx = Transaction::local();
+    ForbiddenColors& forbidden = ForbiddenColors::local();
+    const graphNode node = static_cast<graphNode>(vertex);
+
+    const int thread_id = omp_get_thread_num();
+    const int degree = graph.degree(node);
+    TxnTelemetry::Thread& thread_telemetry = telemetry->thread(thread_id);
+    ContentionManager::Thread& thread_contention = contention->thread(thread_id);
+
+    auto body = [&](Transaction& txn) {
+        forbidden.clear();
+        for (graphNode nb_idx : graph.neighbors(node)) {
+            if (nb_idx != node) {
+                forbidden.forbid(txn.read(&vertex_data[nb_idx].current_color));
+            }
+        }
+        txn.write(&vertex_data[node].current_color, forbidden.firstAvailable());
+    };
+
+    if (thread_contention.preferLock()) {
+        // Still transactional, so threads that keep speculating stay safe. Its
+        // retries are left out of the abort rate, as on the HTM lock path, so
+        // the rate decays and the thread goes back to speculating
+        std::lock_guard<std::mutex> guard(serial_lock);
+        tx.atomically(body, &thread_telemetry, degree);
+        thread_telemetry.recordFallback(degree);
+        thread_contention.finished(0, degree);
+    } else {
+        tx.atomically(body, &thread_telemetry, degree, &thread_contention);
+    }
+    vertex_data[node].status.store(2, std::memory_order_relaxed);
+}
+
+// Marks the larger endpoint of every monochromatic edge as tentative
+template <typename Transaction>
+bool WordSTMColorGraph<Transaction>::detectConflicts(const CSRGraph& graph,
+                                                     std::vector<VertexData>& vertex_data) {
+    PhaseTimer::Scope phase(Phase::ConflictDetection);
+    const int node_count = graph.numVertices();
+    int conflicts = 0;
+
+    #pragma omp parallel for schedule(dynamic, 256) reduction(+ : conflicts)
+    for (int i = 0; i < node_count; i++) {
+        for (graphNode nb_idx : graph.neighbors(i)) {
+            if (nb_idx < i && vertex_data[nb_idx].current_color == vertex_data[i].current_color) {
+                vertex_data[i].status.store(1, std::memory_order_relaxed);
+                conflicts++;
+                break;
+            }
+        }
+    }
+
+    if (conflicts > 0) {
+        std::cout << "STM found " << conflicts << " conflicting vertices" << std::endl;
+    }
+    return conflicts > 0;
+}
+
+template <typename Transaction>
+void WordSTMColorGraph<Transaction>::resolveConflicts(const CSRGraph& graph,
+                                                      std::vector<VertexData>& vertex_data) {
+    PhaseTimer::Scope phase(Phase::ConflictResolution);
+    const int node_count = graph.numVertices();
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < node_count; i++) {
+        if (vertex_data[i].status.load(std::memory_order_relaxed) == 1) {
+            optimisticColoring(i, graph, vertex_data);
+        }
+    }
+}
+
+template <typename Transaction>
+void WordSTMColorGraph<Transaction>::colorGraph(
+    const CSRGraph &graph,
+    std::vector<color> &colors) {
+
+    double start_time = omp_get_wtime();
+    const size_t node_count = graph.numVertices();
+    colors.assign(node_count, -1);
+
+    if (node_count == 0) {
+        std::cout << "Empty graph, nothing to color." << std::endl;
+        return;
+    }
+
+    // Highest degree first, as in the libitm path
+    std::vector<graphNode> ordered_nodes(node_count);
+    {
+        PhaseTimer::Scope phase(Phase::Ordering);
+        std::iota(ordered_nodes.begin(), ordered_nodes.end(), 0);
+        if (!PresetColoringOrder::active()) {
+            std::stable_sort(ordered_nodes.begin(), ordered_nodes.end(),
+                [&graph](graphNode a, graphNode b) {
+                    return graph.degree(a) > graph.degree(b);
+                });
+        }
+    }
+
+    std::vector<VertexData> vertex_data(node_count);
+
+    int active_threads = omp_get_max_threads();
+    if (num_threads > 0) {
+        active_threads = std::min(num_threads, active_threads);
+    }
+    omp_set_num_threads(active_threads);
+    std::cout << "Using " << active_threads << " threads " << std::endl;
+
+    const char* type_names[] = {"libitm", "tl2", "norec"};
+    telemetry.reset(new TxnTelemetry(type_names[static_cast<int>(stm_type)], active_threads));
+    contention.reset(new ContentionManager(contentionPolicyFromEnv(), active_threads));
+    std::vector<ThreadTiming> thread_timings(active_threads);
+
+    #pragma omp parallel
+    {
+        PhaseTimer::Scope phase(Phase::Color);
+        ThreadTiming local_timing;
+        int thread_id = omp_get_thread_num();
+        local_timing.thread_id = thread_id;
+        local_timing.start_time = omp_get_wtime();
+
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < node_count; i++) {
+            optimisticColoring(ordered_nodes[i], graph, vertex_data);
+            local_timing.nodes_processed++;
+        }
+
+        local_timing.retries = telemetry->thread(thread_id).totalAborts();
+        local_timing.end_time = omp_get_wtime();
+        thread_timings[thread_id] = local_timing;
+    }
+
+    telemetry->printSummary(std::cout);
+    contention->printSummary(std::cout);
+    printThreadTimings(thread_timings);
+
+    // Committed transactions are serializable; this only guards against misuse
+    for (int round = 0; round < max_iterations && detectConflicts(graph, vertex_data); round++) {
+        resolveConflicts(graph, vertex_data);
+    }
+
+    {
+        PhaseTimer::Scope phase(Phase::Output);
+        for (size_t i = 0; i < node_count; i++) {
+            colors[i] = vertex_data[i].current_color;
+        }
+    }
+
+    std::cout << "Time spent: " << (omp_get_wtime() - start_time) << " seconds" << std::endl;
+    telemetry->dumpIfRequested();
+}
+
+template class WordSTMColorGraph<tl2::Transaction>;
+template class WordSTMColorGraph<norec::Transaction>;
+
 std::unique_ptr<ColorGraph> createSTMColorGraph(const char* stm_type, int iterations, bool try_bipartite, int num_threads) {
     static thread_local bool registered = false;
     if (!registered) {
@@ -1015,7 +792,10 @@ std::unique_ptr<ColorGraph> createSTMColorGraph(const char* stm_type, int iterat
     
     if (strcmp(stm_type, "tl2") == 0) {
         return std::make_unique<TL2ColorGraph>(iterations, try_bipartite, num_threads);
-    } else {
+    } else if (strcmp(stm_type, "norec") == 0) {
+        return std::make_unique<NOrecColorGraph>(iterations, try_bipartite, num_threads);
+    } else if (strcmp(stm_type, "libitm") == 0) {
         return std::make_unique<LibITMColorGraph>(iterations, try_bipartite, num_threads);
     }
+    return nullptr;
 }
\ No newline at end of file
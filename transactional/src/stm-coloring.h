@@ -1,16 +1,22 @@
 #ifndef STM_COLORING_H
 #define STM_COLORING_H
 
+#include "contention_manager.h"
 #include "graph.h"
+#include "norec.h"
+#include "tl2.h"
+#include "txn_telemetry.h"
 #include <vector>
 #include <unordered_map>
 #include <atomic>
+#include <mutex>
 
 // Maximum number of colors to use
 #define MAX_COLORS 5000
 enum class STMType {
     Libitm,
     TL2,
+    NOrec,
 };
 
 // Data structure for a vertex in the graph
@@ -24,23 +30,17 @@ struct VertexData {
 class STMColorGraph : public ColorGraph {
 private:
 void repairConflicts(
-    std::unordered_map<graphNode, std::vector<graphNode>> &graph,
-    std::unordered_map<graphNode, color> &colors,
-    const std::unordered_map<graphNode, size_t> &node_to_index,
+    const CSRGraph &graph,
+    std::vector<color> &colors,
     const std::vector<graphNode> &ordered_nodes);
 
 public:
     STMColorGraph(STMType type, int iterations, bool try_bipartite, int num_threads=0);
     virtual ~STMColorGraph();
     
-    virtual void buildGraph(
-        std::vector<graphNode>& nodes,
-        std::vector<std::pair<graphNode, graphNode>>& pairs,
-        std::unordered_map<graphNode, std::vector<graphNode>>& graph) override;
-    
     virtual void colorGraph(
-        std::unordered_map<graphNode, std::vector<graphNode>>& graph,
-        std::unordered_map<graphNode, color>& colors) override;
+        const CSRGraph& graph,
+        std::vector<color>& colors) override;
 
 protected:
     STMType stm_type;
@@ -48,16 +48,21 @@ protected:
     bool detect_bipartite;
     color global_max_color;
     int num_threads;
+    // Created per colorGraph call with one slot per thread
+    std::unique_ptr<TxnTelemetry> telemetry;
+    std::unique_ptr<ContentionManager> contention;
+    // Lock path for threads the contention manager takes off speculation
+    std::mutex serial_lock;
 
     
     // Specialized coloring methods for different graph types
     void colorSparseGraph(
-        std::unordered_map<graphNode, std::vector<graphNode>>& graph,
-        std::unordered_map<graphNode, color>& colors);
+        const CSRGraph& graph,
+        std::vector<color>& colors);
         
     void colorLockFreeGraph(
-        std::unordered_map<graphNode, std::vector<graphNode>>& graph,
-        std::unordered_map<graphNode, color>& colors);
+        const CSRGraph& graph,
+        std::vector<color>& colors);
 };
 
 class LibITMColorGraph : public STMColorGraph {
@@ -66,33 +71,51 @@ public:
     
 private:
     void optimisticColoring(size_t vertex,
-                           const std::vector<std::vector<graphNode>>& neighbors,
+                           const CSRGraph& graph,
                            std::vector<VertexData>& vertex_data);
     
-    bool detectConflicts(const std::vector<std::vector<graphNode>>& neighbors,
+    bool detectConflicts(const CSRGraph& graph,
                         std::vector<VertexData>& vertex_data);
     
-    void resolveConflicts(const std::vector<std::vector<graphNode>>& neighbors,
+    void resolveConflicts(const CSRGraph& graph,
                          std::vector<VertexData>& vertex_data);
 };
 
-class TL2ColorGraph : public STMColorGraph {
+// Colors every vertex in its own transaction on one of the in-tree word-based
+// STMs; Transaction is tl2::Transaction or norec::Transaction
+template <typename Transaction>
+class WordSTMColorGraph : public STMColorGraph {
 public:
-    TL2ColorGraph(int iterations, bool try_bipartite, int num_threads=0);
+    WordSTMColorGraph(STMType type, int iterations, bool try_bipartite, int num_threads);
+
+    void colorGraph(
+        const CSRGraph& graph,
+        std::vector<color>& colors) override;
     
 private:
     void optimisticColoring(size_t vertex,
-                           const std::vector<std::vector<graphNode>>& neighbors,
+                           const CSRGraph& graph,
                            std::vector<VertexData>& vertex_data);
     
-    bool detectConflicts(const std::vector<std::vector<graphNode>>& neighbors,
+    bool detectConflicts(const CSRGraph& graph,
                         std::vector<VertexData>& vertex_data);
     
-    void resolveConflicts(const std::vector<std::vector<graphNode>>& neighbors,
+    void resolveConflicts(const CSRGraph& graph,
                          std::vector<VertexData>& vertex_data);
 };
 
-// Factory function to create the appropriate STM implementation
+class TL2ColorGraph : public WordSTMColorGraph<tl2::Transaction> {
+public:
+    TL2ColorGraph(int iterations, bool try_bipartite, int num_threads=0);
+};
+
+class NOrecColorGraph : public WordSTMColorGraph<norec::Transaction> {
+public:
+    NOrecColorGraph(int iterations, bool try_bipartite, int num_threads=0);
+};
+
+// Factory function to create the appropriate STM implementation: "libitm", "tl2"
+// or "norec"; returns nullptr for any other name
 std::unique_ptr<ColorGraph> createSTMColorGraph(const char* stm_type, int iterations, bool try_bipartite, int num_threads);
 
 #endif // STM_COLORING_H
\ No newline at end of file
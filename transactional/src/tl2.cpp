@@ -0,0 +1,195 @@
+#include "tl2.h"
+
+#include <immintrin.h>
+
+namespace tl2 {
+
+namespace {
+
+// Version of the latest commit; unlocked lock words hold version << 1
+alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> global_clock{0};
+
+std::atomic<uint64_t> lock_table[1 << 20];
+
+// What other threads need to arbitrate against a lock holder
+struct alignas(CACHE_LINE_SIZE) HolderSlot {
+    std::atomic<bool> taken{false};
+    std::atomic<uint64_t> karma{0};
+    std::atomic<uint64_t> status{0};  // (serial << 2) | state of the holder's current attempt
+};
+
+enum AttemptState : uint64_t { Running = 0, Killed = 1, WritingBack = 2 };
+
+const int MAX_HOLDERS = 1024;
+HolderSlot holders[MAX_HOLDERS];
+
+// Spins a winner waits for a killed or writing-back holder before giving up
+const int RELEASE_WAIT_SPINS = 1 << 12;
+
+} // namespace
+
+Transaction::Transaction() {
+    for (int i = 0; i < MAX_HOLDERS; i++) {
+        bool expected = false;
+        if (holders[i].taken.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            slot = i;
+            // Serials keep growing across owners, so a stale kill cannot match
+            serial = holders[i].status.load(std::memory_order_relaxed) >> 2;
+            return;
+        }
+    }
+}
+
+Transaction::~Transaction() {
+    if (slot >= 0) holders[slot].taken.store(false, std::memory_order_release);
+}
+
+std::atomic<uint64_t> &Transaction::lockFor(const void *addr) {
+    static_assert(sizeof(lock_table) / sizeof(lock_table[0]) == (1u << LOCK_TABLE_BITS),
+                  "lock table size");
+    // 4-byte stripes: adjacent vertex colors never share a lock
+    uintptr_t word = reinterpret_cast<uintptr_t>(addr) >> 2;
+    return lock_table[word & ((1u << LOCK_TABLE_BITS) - 1)];
+}
+
+Transaction &Transaction::local() {
+    static thread_local Transaction instance;
+    return instance;
+}
+
+void Transaction::begin() {
+    read_set.clear();
+    write_set.clear();
+    held_locks.clear();
+    if (slot >= 0) {
+        serial++;
+        holders[slot].karma.store(arbitrate ? karma : 0, std::memory_order_relaxed);
+        holders[slot].status.store((serial << 2) | Running, std::memory_order_release);
+    }
+    read_version = global_clock.load(std::memory_order_acquire);
+}
+
+bool Transaction::killed() const {
+    return slot >= 0 &&
+           (holders[slot].status.load(std::memory_order_acquire) & 3) == Killed;
+}
+
+bool Transaction::outranksHolder(std::atomic<uint64_t> &lock, uint64_t word) {
+    const int holder = holderOf(word);
+    if (!arbitrate || slot < 0 || holder < 0 || holder == slot) return false;
+    HolderSlot &other = holders[holder];
+    if (karma <= other.karma.load(std::memory_order_relaxed)) return false;
+
+    // The lock still holding word after the status load means this serial
+    // took it, so the kill cannot land on a later attempt of the holder
+    uint64_t status = other.status.load(std::memory_order_acquire);
+    if ((status & 3) == Running && lock.load(std::memory_order_acquire) == word) {
+        other.status.compare_exchange_strong(status, (status & ~uint64_t(3)) | Killed,
+                                             std::memory_order_acq_rel);
+    }
+    // Killed or writing back, the holder releases the word shortly
+    return true;
+}
+
+void Transaction::waitForRelease(std::atomic<uint64_t> &lock, uint64_t word) {
+    if (!outranksHolder(lock, word)) throw Abort{AbortCause::LockHeld};
+    for (int spin = 0; spin < RELEASE_WAIT_SPINS; spin++) {
+        if (lock.load(std::memory_order_acquire) != word) return;
+        // A waiter inside commit may itself be killed by a richer transaction
+        if (killed()) throw Abort{AbortCause::Conflict};
+        _mm_pause();
+    }
+    throw Abort{AbortCause::LockHeld};
+}
+
+bool Transaction::validateReadSet() const {
+    for (std::atomic<uint64_t> *lock : read_set) {
+        uint64_t word = lock->load(std::memory_order_acquire);
+        if (isLocked(word)) {
+            // Only our own commit may hold it, and then its old version counts
+            bool ours = false;
+            for (const HeldLock &held : held_locks) {
+                if (held.lock == lock) {
+                    ours = true;
+                    word = held.previous;
+                    break;
+                }
+            }
+            if (!ours) return false;
+        }
+        if (versionOf(word) > read_version) return false;
+    }
+    return true;
+}
+
+void Transaction::commit() {
+    if (write_set.empty()) {
+        // Every read was validated against read_version as it happened
+        return;
+    }
+
+    for (const WriteEntry &entry : write_set) {
+        std::atomic<uint64_t> *lock = &lockFor(entry.addr);
+        bool held = false;
+        for (const HeldLock &h : held_locks) {
+            if (h.lock == lock) {
+                held = true;
+                break;
+            }
+        }
+        if (held) continue;
+
+        uint64_t word = lock->load(std::memory_order_relaxed);
+        while (isLocked(word)) {
+            waitForRelease(*lock, word);
+            word = lock->load(std::memory_order_relaxed);
+        }
+        if (versionOf(word) > read_version) {
+            throw Abort{AbortCause::Conflict};
+        }
+        if (!lock->compare_exchange_strong(word, lockedWord(), std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+            throw Abort{AbortCause::LockHeld};
+        }
+        held_locks.push_back({lock, word});
+    }
+
+    uint64_t write_version = global_clock.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    // Nobody committed since begin, so the read set cannot have changed
+    if (write_version != read_version + 1 && !validateReadSet()) {
+        throw Abort{AbortCause::Conflict};
+    }
+
+    // Past this point the attempt can no longer be killed
+    if (slot >= 0) {
+        uint64_t running = (serial << 2) | Running;
+        if (!holders[slot].status.compare_exchange_strong(running, (serial << 2) | WritingBack,
+                                                          std::memory_order_acq_rel)) {
+            throw Abort{AbortCause::Conflict};
+        }
+    }
+
+    for (const WriteEntry &entry : write_set) {
+        if (entry.size == sizeof(uint32_t)) {
+            __atomic_store_n(static_cast<uint32_t *>(entry.addr),
+                             static_cast<uint32_t>(entry.value), __ATOMIC_RELAXED);
+        } else {
+            __atomic_store_n(static_cast<uint64_t *>(entry.addr), entry.value, __ATOMIC_RELAXED);
+        }
+    }
+
+    for (const HeldLock &held : held_locks) {
+        held.lock->store(write_version << 1, std::memory_order_release);
+    }
+    held_locks.clear();
+}
+
+void Transaction::rollback() {
+    for (const HeldLock &held : held_locks) {
+        held.lock->store(held.previous, std::memory_order_release);
+    }
+    held_locks.clear();
+}
+
+} // namespace tl2
@@ -0,0 +1,190 @@
+/**
+ * @file tl2.h
+ * @brief Word-based TL2 software transactional memory
+ *
+ * Transactional Locking II (Dice, Shalev and Shavit, DISC 2006). A global
+ * version clock orders commits and every word maps to one of a table of
+ * striped versioned write-locks. Reads are validated against the clock value
+ * sampled at begin, writes go to a redo log, and commit locks the write set,
+ * revalidates the read set and publishes the log. Transactions never see an
+ * inconsistent snapshot, so a committed coloring step needs no repair.
+ *
+ * Under the karma and adaptive contention policies, conflicts on a locked
+ * word are arbitrated (Scherer and Scott, PODC 2005): each attempt publishes
+ * its karma, the work its transaction has lost to aborts, and a locked word
+ * names its holder. A transaction that meets a holder with less karma kills
+ * it and waits for the word instead of aborting; otherwise it aborts itself
+ * as plain TL2 does. A holder can only be killed before its write-back.
+ *
+ * The coloring engines read a neighborhood and write one color, so read sets
+ * are degree-sized and write sets hold a single word; both logs are flat
+ * vectors searched linearly, which beats hashing at that size.
+ */
+
+#ifndef TL2_H
+#define TL2_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "csr_graph.h"
+#include "contention_manager.h"
+#include "txn_telemetry.h"
+
+namespace tl2 {
+
+// Thrown by read() and commit() when the transaction has to restart
+struct Abort {
+    AbortCause cause;
+};
+
+class Transaction {
+public:
+    /**
+     * @brief Transaction descriptor owned by the calling thread
+     */
+    static Transaction &local();
+
+    void begin();
+
+    /**
+     * @brief Transactional load of a 4- or 8-byte word
+     */
+    template <typename T>
+    T read(const T *addr) {
+        static_assert(std::is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                      "TL2 words are 4- or 8-byte integers");
+        // Read-after-write sees the redo log
+        for (const WriteEntry &entry : write_set) {
+            if (entry.addr == addr) return static_cast<T>(entry.value);
+        }
+
+        std::atomic<uint64_t> &lock = lockFor(addr);
+        while (true) {
+            uint64_t before = lock.load(std::memory_order_acquire);
+            T value = __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+            uint64_t after = lock.load(std::memory_order_acquire);
+            if (isLocked(before)) {
+                waitForRelease(lock, before);
+                continue;
+            }
+            if (before != after || versionOf(before) > read_version) {
+                throw Abort{AbortCause::Conflict};
+            }
+            read_set.push_back(&lock);
+            return value;
+        }
+    }
+
+    /**
+     * @brief Buffers a store until commit
+     */
+    template <typename T>
+    void write(T *addr, T value) {
+        static_assert(std::is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                      "TL2 words are 4- or 8-byte integers");
+        for (WriteEntry &entry : write_set) {
+            if (entry.addr == addr) {
+                entry.value = static_cast<uint64_t>(value);
+                return;
+            }
+        }
+        write_set.push_back({addr, static_cast<uint64_t>(value), sizeof(T)});
+    }
+
+    /**
+     * @brief Publishes the redo log; throws Abort if the read set went stale
+     */
+    void commit();
+
+    /**
+     * @brief Runs body(tx) until it commits, backing off between attempts
+     *
+     * Commits, aborts by cause and backoff time go to telemetry if given,
+     * bucketed by the degree of the vertex the transaction colors. With a
+     * contention manager the waits follow its policy and the outcome feeds
+     * its abort-rate estimate; otherwise plain randomized backoff is used.
+     * Lock conflicts are arbitrated by karma if the policy asks for it.
+     */
+    template <typename Body>
+    void atomically(Body &&body, TxnTelemetry::Thread *telemetry = nullptr, int degree = 0,
+                    ContentionManager::Thread *contention = nullptr) {
+        int attempt = 0;
+        karma = 0;
+        arbitrate = contention && contention->arbitrates();
+        while (true) {
+            begin();
+            try {
+                body(*this);
+                commit();
+                if (telemetry) telemetry->recordCommit(degree);
+                if (contention) contention->finished(attempt, degree);
+                return;
+            } catch (const Abort &abort) {
+                rollback();
+                if (telemetry) telemetry->recordAbort(abort.cause, degree);
+                karma += read_set.size();
+                attempt++;
+                if (contention) {
+                    contention->backoff(attempt, karma, telemetry);
+                } else {
+                    backoff.pause(attempt);
+                }
+            }
+        }
+    }
+
+    Transaction();
+    ~Transaction();
+
+    Transaction(const Transaction &) = delete;
+    Transaction &operator=(const Transaction &) = delete;
+
+private:
+    struct WriteEntry {
+        void *addr;
+        uint64_t value;
+        unsigned size;
+    };
+
+    struct HeldLock {
+        std::atomic<uint64_t> *lock;
+        uint64_t previous;  // Lock word before we took it, restored on abort
+    };
+
+    static const int LOCK_TABLE_BITS = 20;
+
+    // An unlocked word holds (version << 1); a locked one (holder slot + 1) << 1 | 1
+    static bool isLocked(uint64_t word) { return word & 1; }
+    static uint64_t versionOf(uint64_t word) { return word >> 1; }
+    static int holderOf(uint64_t word) { return static_cast<int>(word >> 1) - 1; }
+    static std::atomic<uint64_t> &lockFor(const void *addr);
+
+    uint64_t lockedWord() const { return (static_cast<uint64_t>(slot + 1) << 1) | 1; }
+
+    /**
+     * @brief Returns once lock no longer holds word; throws Abort unless we outrank its holder
+     */
+    void waitForRelease(std::atomic<uint64_t> &lock, uint64_t word);
+    bool outranksHolder(std::atomic<uint64_t> &lock, uint64_t word);
+    bool killed() const;
+
+    void rollback();
+    bool validateReadSet() const;
+
+    int slot = -1;  // Entry in the holder table; -1 if it was full, which opts out of arbitration
+    uint64_t serial = 0;  // Attempt number, so a kill never reaches a later attempt
+    uint64_t karma = 0;  // Words read by this transaction's aborted attempts
+    bool arbitrate = false;
+    uint64_t read_version = 0;
+    std::vector<std::atomic<uint64_t> *> read_set;
+    std::vector<WriteEntry> write_set;
+    std::vector<HeldLock> held_locks;
+    RandomizedBackoff backoff;
+};
+
+} // namespace tl2
+
+#endif // TL2_H
@@ -15,12 +15,28 @@ declare -A CACHE_MISSES
 declare -A L1_MISSES
 declare -A LLC_MISSES
 
+# STM backend under test: tl2, norec or libitm (STM_BACKEND=norec ./benchmark.sh)
+STM_BACKEND=${STM_BACKEND:-tl2}
+
+# Text to binary graph converter (make convert in traditional/)
+CONVERTER=../traditional/graph_convert
+
+# Binary copy of a test file if one could be made, otherwise the text file
+graph_input() {
+    local file=$1
+    if [ -f "${file%.txt}.csr" ]; then
+        echo "${file%.txt}.csr"
+    else
+        echo "$file"
+    fi
+}
+
 # Function to run a test
 run_test() {
     local threads=$1
     local file=$2
     
-    echo "Running STM with $threads threads on $file"
+    echo "Running STM ($STM_BACKEND) with $threads threads on $file"
     export OMP_NUM_THREADS=$threads
     
     # Temporary file for perf output
@@ -30,10 +46,10 @@ run_test() {
     echo "Running perf stat..."
     perf stat -e cache-references,cache-misses,L1-dcache-load-misses,L1-dcache-store-misses,LLC-load-misses,LLC-store-misses \
               -o $perf_output \
-              ./color-transactional -stm -t $threads -f $file 2>&1
+              ./color-transactional -stm_backend $STM_BACKEND -t $threads -f $(graph_input $file) 2>&1
     
     # Capture the actual program output
-    program_output=$(./color-transactional -stm -t $threads -f $file 2>&1)
+    program_output=$(./color-transactional -stm_backend $STM_BACKEND -t $threads -f $(graph_input $file) 2>&1)
     echo "$program_output"
     
     # Try multiple patterns to extract time
@@ -91,6 +107,15 @@ echo "==================== STM Graph Coloring Benchmark ===================="
 printf "%-6s %-15s %-8s %-8s %-12s\n" "Threads" "File" "Time(s)" "Colors" "Correctness"
 echo "===================================================================="
 
+# Convert every test file once so the runs below skip text parsing
+if [ -x "$CONVERTER" ]; then
+    for file in "${FILES[@]}"; do
+        if [ -f "$file" ] && [ ! "${file%.txt}.csr" -nt "$file" ]; then
+            "$CONVERTER" "$file" "${file%.txt}.csr" || rm -f "${file%.txt}.csr"
+        fi
+    done
+fi
+
 # Main test loop
 for file in "${FILES[@]}"; do
     echo "Processing file: $file"